@@ -0,0 +1,243 @@
+#ifndef ALLOCATION_GUARD_H
+#define ALLOCATION_GUARD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+
+// Переключатель счетчиков для allocation_guard: -DMY_ALLOCATOR_GUARD=1
+// встраивает подсчет вызовов my_allocator::allocate в поток. Без него
+// охрана компилируется, но всегда видит ноль вызовов аллокатора
+#ifndef MY_ALLOCATOR_GUARD
+#define MY_ALLOCATOR_GUARD 0
+#endif
+
+// Охрана бюджета аллокаций участка кода: RAII-объект запоминает счетчики
+// потока при создании и сравнивает прирост с бюджетом при разрушении.
+// Считаются вызовы my_allocator::allocate и, если в программе есть
+// ALLOCATION_GUARD_DEFINE_GLOBAL_NEW(), глобальный operator new.
+// Учитывается только текущий поток
+namespace allocation_guard_detail {
+
+struct counters {
+    std::uint64_t allocator_calls;
+    std::uint64_t allocator_bytes;
+    std::uint64_t new_calls;
+    std::uint64_t new_bytes;
+};
+
+// Тривиальный thread_local: доступен из operator new в любой момент жизни потока
+inline thread_local counters tls{0, 0, 0, 0};
+inline bool global_new_counted = false;  // Задается ALLOCATION_GUARD_DEFINE_GLOBAL_NEW
+
+inline void count_allocator(std::size_t bytes) noexcept {
+    ++tls.allocator_calls;
+    tls.allocator_bytes += bytes;
+}
+
+inline void count_new(std::size_t bytes) noexcept {
+    ++tls.new_calls;
+    tls.new_bytes += bytes;
+}
+
+} // namespace allocation_guard_detail
+
+// Бюджет; по умолчанию без ограничений
+struct allocation_budget {
+    static constexpr std::uint64_t unlimited = std::numeric_limits<std::uint64_t>::max();
+
+    std::uint64_t allocator_calls = unlimited;  // Вызовы my_allocator::allocate
+    std::uint64_t new_calls = unlimited;        // Вызовы глобального operator new
+    std::uint64_t bytes = unlimited;            // Байты обоих источников
+
+    // Ни одной аллокации
+    static allocation_budget none() noexcept { return at_most(0); }
+
+    // Не больше n аллокаций каждого вида
+    static allocation_budget at_most(std::uint64_t n) noexcept {
+        allocation_budget budget;
+        budget.allocator_calls = n;
+        budget.new_calls = n;
+        return budget;
+    }
+};
+
+// Прирост счетчиков за время жизни охраны
+struct allocation_usage {
+    std::uint64_t allocator_calls = 0;
+    std::uint64_t allocator_bytes = 0;
+    std::uint64_t new_calls = 0;
+    std::uint64_t new_bytes = 0;
+};
+
+class allocation_guard {
+public:
+    enum class action {
+        report,  // Сообщение в stderr, итог помечается нарушением
+        abort,   // Сообщение и std::abort - как assert, но и в release
+    };
+
+    explicit allocation_guard(const char* name, allocation_budget budget = allocation_budget(),
+                              action on_exceed = action::report) noexcept
+        : name_(name), budget_(budget), on_exceed_(on_exceed), start_(allocation_guard_detail::tls) {}
+
+    ~allocation_guard() {
+        allocation_usage used = usage();
+        bool over = exceeded(used);
+        record(used, over);
+        if (!over) return;
+        std::fprintf(stderr, "allocation_guard \"%s\": бюджет превышен: allocate %llu (бюджет %s), "
+                             "operator new %llu (бюджет %s), байт %llu (бюджет %s)\n",
+                     name_,
+                     static_cast<unsigned long long>(used.allocator_calls), limit(budget_.allocator_calls).c_str(),
+                     static_cast<unsigned long long>(used.new_calls), limit(budget_.new_calls).c_str(),
+                     static_cast<unsigned long long>(used.allocator_bytes + used.new_bytes), limit(budget_.bytes).c_str());
+        if (on_exceed_ == action::abort) std::abort();
+    }
+
+    allocation_guard(const allocation_guard&) = delete;
+    allocation_guard& operator=(const allocation_guard&) = delete;
+
+    // Прирост на текущий момент
+    allocation_usage usage() const noexcept {
+        const auto& now = allocation_guard_detail::tls;
+        allocation_usage used;
+        used.allocator_calls = now.allocator_calls - start_.allocator_calls;
+        used.allocator_bytes = now.allocator_bytes - start_.allocator_bytes;
+        used.new_calls = now.new_calls - start_.new_calls;
+        used.new_bytes = now.new_bytes - start_.new_bytes;
+        return used;
+    }
+
+    // Для проверок в тестах до выхода из области
+    bool within_budget() const noexcept { return !exceeded(usage()); }
+
+    // Итог по всем охранам с одинаковым именем
+    struct scope_summary {
+        std::uint64_t entries = 0;
+        std::uint64_t violations = 0;
+        std::uint64_t allocator_calls = 0;
+        std::uint64_t new_calls = 0;
+        std::uint64_t bytes = 0;
+        std::uint64_t max_calls_per_entry = 0;  // Больший из двух видов
+    };
+
+    static std::map<std::string, scope_summary> summary() {
+        auto& s = state::instance();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.scopes;
+    }
+
+    static void print_summary(std::ostream& out) {
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-32s %10s %10s %12s %12s %14s %12s\n",
+                      "scope", "entries", "violations", "allocate", "new", "bytes", "max/entry");
+        out << line;
+        for (const auto& entry : summary()) {
+            const scope_summary& scope = entry.second;
+            std::snprintf(line, sizeof(line), "%-32.32s %10llu %10llu %12llu %12llu %14llu %12llu\n",
+                          entry.first.c_str(),
+                          static_cast<unsigned long long>(scope.entries),
+                          static_cast<unsigned long long>(scope.violations),
+                          static_cast<unsigned long long>(scope.allocator_calls),
+                          static_cast<unsigned long long>(scope.new_calls),
+                          static_cast<unsigned long long>(scope.bytes),
+                          static_cast<unsigned long long>(scope.max_calls_per_entry));
+            out << line;
+        }
+        if (!allocation_guard_detail::global_new_counted) {
+            out << "(operator new не считается: нет ALLOCATION_GUARD_DEFINE_GLOBAL_NEW)\n";
+        }
+    }
+
+    static void reset_summary() {
+        auto& s = state::instance();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.scopes.clear();
+    }
+
+private:
+    struct state {
+        std::mutex mutex;
+        std::map<std::string, scope_summary> scopes;
+
+        static state& instance() {
+            static state* s = new state();  // Не разрушается: охраны возможны в потоках после main
+            return *s;
+        }
+    };
+
+    bool exceeded(const allocation_usage& used) const noexcept {
+        return used.allocator_calls > budget_.allocator_calls ||
+               used.new_calls > budget_.new_calls ||
+               used.allocator_bytes + used.new_bytes > budget_.bytes;
+    }
+
+    void record(const allocation_usage& used, bool over) noexcept {
+        // Сама запись итога аллоцирует, поэтому счетчики потока восстанавливаются
+        allocation_guard_detail::counters saved = allocation_guard_detail::tls;
+        try {
+            auto& s = state::instance();
+            std::lock_guard<std::mutex> lock(s.mutex);
+            scope_summary& scope = s.scopes[name_];
+            ++scope.entries;
+            scope.violations += over;
+            scope.allocator_calls += used.allocator_calls;
+            scope.new_calls += used.new_calls;
+            scope.bytes += used.allocator_bytes + used.new_bytes;
+            std::uint64_t calls = used.allocator_calls > used.new_calls ? used.allocator_calls : used.new_calls;
+            if (calls > scope.max_calls_per_entry) scope.max_calls_per_entry = calls;
+        } catch (...) {
+        }
+        allocation_guard_detail::tls = saved;
+    }
+
+    static std::string limit(std::uint64_t value) {
+        return value == allocation_budget::unlimited ? "нет" : std::to_string(value);
+    }
+
+    const char* name_;
+    allocation_budget budget_;
+    action on_exceed_;
+    allocation_guard_detail::counters start_;
+};
+
+// Подсчет глобального operator new: макрос ставится ровно в один .cpp
+// программы (обычно рядом с main тестов). Выровненные формы
+// (std::align_val_t) не заменяются и не считаются
+#define ALLOCATION_GUARD_DEFINE_GLOBAL_NEW()                                              \
+    namespace {                                                                           \
+    struct allocation_guard_global_new_marker {                                           \
+        allocation_guard_global_new_marker() { allocation_guard_detail::global_new_counted = true; } \
+    } allocation_guard_global_new_marker_instance;                                        \
+    void* allocation_guard_counted_new(std::size_t size) {                                \
+        allocation_guard_detail::count_new(size);                                         \
+        if (void* p = std::malloc(size ? size : 1)) return p;                             \
+        throw std::bad_alloc();                                                           \
+    }                                                                                     \
+    }                                                                                     \
+    void* operator new(std::size_t size) { return allocation_guard_counted_new(size); }  \
+    void* operator new[](std::size_t size) { return allocation_guard_counted_new(size); } \
+    void* operator new(std::size_t size, const std::nothrow_t&) noexcept {                \
+        allocation_guard_detail::count_new(size);                                         \
+        return std::malloc(size ? size : 1);                                              \
+    }                                                                                     \
+    void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {              \
+        allocation_guard_detail::count_new(size);                                         \
+        return std::malloc(size ? size : 1);                                              \
+    }                                                                                     \
+    void operator delete(void* p) noexcept { std::free(p); }                              \
+    void operator delete[](void* p) noexcept { std::free(p); }                            \
+    void operator delete(void* p, std::size_t) noexcept { std::free(p); }                 \
+    void operator delete[](void* p, std::size_t) noexcept { std::free(p); }               \
+    void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }       \
+    void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+#endif
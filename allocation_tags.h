@@ -0,0 +1,320 @@
+#ifndef ALLOCATION_TAGS_H
+#define ALLOCATION_TAGS_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Переключатель учета по тегам: -DMY_ALLOCATOR_TAGS=1 включает счетчики
+// по тегам в my_allocator и автоматический тег по месту создания аллокатора
+// (для my_container - по месту создания контейнера; контейнерам STL нужен
+// явный тег, иначе местом окажется их заголовок).
+// Без него теги принимаются в API, но ничего не стоят. Профиль времени
+// жизни (MY_ALLOCATOR_LIFETIME) группирует по тегам и включает их сам
+#ifndef MY_ALLOCATOR_TAGS
+#if defined(MY_ALLOCATOR_LIFETIME) && MY_ALLOCATOR_LIFETIME
+#define MY_ALLOCATOR_TAGS 1
+#else
+#define MY_ALLOCATOR_TAGS 0
+#endif
+#endif
+
+// Место вызова - замена std::source_location (C++20) на встроенных
+// функциях компилятора; как аргумент по умолчанию дает место вызывающего
+#if defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1926)
+#define ALLOCATION_SITE_FILE __builtin_FILE()
+#define ALLOCATION_SITE_LINE __builtin_LINE()
+#define ALLOCATION_SITE_FUNCTION __builtin_FUNCTION()
+#else
+#define ALLOCATION_SITE_FILE "?"
+#define ALLOCATION_SITE_LINE 0
+#define ALLOCATION_SITE_FUNCTION "?"
+#endif
+
+struct allocation_site {
+    const char* file;
+    unsigned line;
+    const char* function;
+
+    static allocation_site current(const char* file = ALLOCATION_SITE_FILE,
+                                   unsigned line = ALLOCATION_SITE_LINE,
+                                   const char* function = ALLOCATION_SITE_FUNCTION) noexcept {
+        return {file, line, function};
+    }
+};
+
+// Место создания для конструкторов по умолчанию: аргумент по умолчанию
+// creation_site() получает строку того, кто создает объект. Неявно из
+// allocation_site не получается, поэтому такой конструктор не служит
+// преобразованием из места вызова
+struct creation_site {
+    allocation_site site;
+
+    explicit creation_site(allocation_site where = allocation_site::current()) noexcept : site(where) {}
+};
+
+// Тег - небольшой номер в таблице имен. 0 - без тега, последний номер
+// собирает все, что не поместилось в таблицу
+class allocation_tag {
+public:
+    static constexpr std::uint16_t untagged_id = 0;
+    static constexpr std::uint16_t max_tags = 256;
+    static constexpr std::uint16_t overflow_id = max_tags - 1;
+
+    constexpr allocation_tag() noexcept : id_(untagged_id) {}
+
+    // Тег с именем; одинаковые имена дают один тег
+    static allocation_tag named(const char* name) noexcept;
+    // Тег места вызова: "файл:строка функция"
+    static allocation_tag at(const allocation_site& site) noexcept;
+
+    constexpr std::uint16_t id() const noexcept { return id_; }
+    const char* name() const noexcept;
+
+    constexpr bool operator==(allocation_tag other) const noexcept { return id_ == other.id_; }
+    constexpr bool operator!=(allocation_tag other) const noexcept { return id_ != other.id_; }
+
+private:
+    constexpr explicit allocation_tag(std::uint16_t id) noexcept : id_(id) {}
+    std::uint16_t id_;
+};
+
+// Потребление по одному тегу
+struct tag_usage {
+    std::string name;
+    std::uint64_t allocations = 0;
+    std::uint64_t deallocations = 0;
+    std::uint64_t allocated_bytes = 0;
+    std::uint64_t live_bytes = 0;
+    double allocations_per_second = 0.0;  // С предыдущего отчета
+    double bytes_per_second = 0.0;
+};
+
+namespace allocation_tags {
+
+namespace detail {
+
+// Счетчики одного потока по всем тегам; пишет только владелец,
+// поэтому relaxed load + store, как в allocator_stats.h
+struct thread_counters {
+    struct per_tag {
+        std::atomic<std::uint64_t> allocations{0};
+        std::atomic<std::uint64_t> deallocations{0};
+        std::atomic<std::uint64_t> allocated_bytes{0};
+        std::atomic<std::uint64_t> deallocated_bytes{0};
+    };
+    per_tag tags[allocation_tag::max_tags];
+};
+
+struct registry {
+    std::mutex mutex;
+    std::deque<std::string> names{"untagged"};  // deque: name() отдает указатели на строки
+    std::unordered_map<std::string, std::uint16_t> ids{{"untagged", allocation_tag::untagged_id}};
+    std::vector<thread_counters*> blocks;
+    std::vector<thread_counters*> free_blocks;
+
+    // Предыдущий отчет - для расчета темпа
+    std::chrono::steady_clock::time_point last_report = std::chrono::steady_clock::now();
+    std::vector<std::uint64_t> last_allocations = std::vector<std::uint64_t>(allocation_tag::max_tags);
+    std::vector<std::uint64_t> last_bytes = std::vector<std::uint64_t>(allocation_tag::max_tags);
+
+    static registry& instance() {
+        static registry* r = new registry();
+        return *r;
+    }
+
+    std::uint16_t intern(const std::string& name) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+        if (names.size() >= allocation_tag::overflow_id) return allocation_tag::overflow_id;
+        auto id = static_cast<std::uint16_t>(names.size());
+        names.push_back(name);
+        ids.emplace(name, id);
+        return id;
+    }
+};
+
+inline thread_local thread_counters* tls_counters = nullptr;
+
+struct thread_slot {
+    ~thread_slot() {
+        registry& r = registry::instance();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.free_blocks.push_back(tls_counters);
+        tls_counters = nullptr;
+    }
+};
+
+inline thread_counters* attach() noexcept {
+    registry& r = registry::instance();
+    try {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        if (!r.free_blocks.empty()) {
+            tls_counters = r.free_blocks.back();
+            r.free_blocks.pop_back();
+        } else {
+            tls_counters = new thread_counters();
+            r.blocks.push_back(tls_counters);
+        }
+    } catch (...) {
+        return nullptr;
+    }
+    thread_local thread_slot slot;
+    (void)slot;
+    return tls_counters;
+}
+
+inline thread_counters* local() noexcept {
+    thread_counters* counters = tls_counters;
+    return counters ? counters : attach();
+}
+
+inline void bump(std::atomic<std::uint64_t>& counter, std::uint64_t delta) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+// Кэш места вызова -> тег в потоке, чтобы не брать mutex на каждое создание
+struct site_cache_entry {
+    const char* file = nullptr;
+    unsigned line = 0;
+    std::uint16_t id = 0;
+};
+
+inline thread_local site_cache_entry site_cache[64];
+
+} // namespace detail
+
+// Учет операций аллокатора
+inline void record_allocate(allocation_tag tag, std::size_t bytes) noexcept {
+    if (auto* counters = detail::local()) {
+        auto& t = counters->tags[tag.id()];
+        detail::bump(t.allocations, 1);
+        detail::bump(t.allocated_bytes, bytes);
+    }
+}
+
+inline void record_deallocate(allocation_tag tag, std::size_t bytes) noexcept {
+    if (auto* counters = detail::local()) {
+        auto& t = counters->tags[tag.id()];
+        detail::bump(t.deallocations, 1);
+        detail::bump(t.deallocated_bytes, bytes);
+    }
+}
+
+// Потребление по тегам, по убыванию живых байт; top = 0 - все теги.
+// Темп считается с момента предыдущего вызова report
+inline std::vector<tag_usage> report(std::size_t top = 0) {
+    auto& r = detail::registry::instance();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - r.last_report).count();
+
+    std::vector<tag_usage> result;
+    for (std::size_t id = 0; id < allocation_tag::max_tags; ++id) {
+        tag_usage usage;
+        std::uint64_t deallocated = 0;
+        for (const auto* block : r.blocks) {
+            const auto& t = block->tags[id];
+            usage.allocations += t.allocations.load(std::memory_order_relaxed);
+            usage.deallocations += t.deallocations.load(std::memory_order_relaxed);
+            usage.allocated_bytes += t.allocated_bytes.load(std::memory_order_relaxed);
+            deallocated += t.deallocated_bytes.load(std::memory_order_relaxed);
+        }
+        if (usage.allocations == 0) continue;
+        usage.name = id == allocation_tag::overflow_id ? "(other)"
+                   : id < r.names.size() ? r.names[id] : "?";
+        usage.live_bytes = usage.allocated_bytes - deallocated;
+        if (seconds > 0.0) {
+            usage.allocations_per_second = static_cast<double>(usage.allocations - r.last_allocations[id]) / seconds;
+            usage.bytes_per_second = static_cast<double>(usage.allocated_bytes - r.last_bytes[id]) / seconds;
+        }
+        r.last_allocations[id] = usage.allocations;
+        r.last_bytes[id] = usage.allocated_bytes;
+        result.push_back(std::move(usage));
+    }
+    r.last_report = now;
+
+    std::sort(result.begin(), result.end(), [](const tag_usage& a, const tag_usage& b) {
+        return a.live_bytes > b.live_bytes;
+    });
+    if (top && result.size() > top) result.resize(top);
+    return result;
+}
+
+// Имя тега по номеру
+inline std::string name_of(std::uint16_t id) {
+    if (id == allocation_tag::overflow_id) return "(other)";
+    auto& r = detail::registry::instance();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    return id < r.names.size() ? r.names[id] : "?";
+}
+
+// Таблица крупнейших потребителей
+inline void dump(std::ostream& out, std::size_t top = 10) {
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-48s %14s %12s %12s %14s\n",
+                  "tag", "live_bytes", "allocs", "allocs/s", "bytes/s");
+    out << line;
+    for (const auto& usage : report(top)) {
+        std::snprintf(line, sizeof(line), "%-48.48s %14llu %12llu %12.0f %14.0f\n",
+                      usage.name.c_str(),
+                      static_cast<unsigned long long>(usage.live_bytes),
+                      static_cast<unsigned long long>(usage.allocations),
+                      usage.allocations_per_second, usage.bytes_per_second);
+        out << line;
+    }
+}
+
+} // namespace allocation_tags
+
+inline allocation_tag allocation_tag::named(const char* name) noexcept {
+    try {
+        return allocation_tag(allocation_tags::detail::registry::instance().intern(name));
+    } catch (...) {
+        return allocation_tag(overflow_id);
+    }
+}
+
+inline allocation_tag allocation_tag::at(const allocation_site& site) noexcept {
+    // Строки __builtin_FILE одного файла обычно совпадают по адресу
+    auto& entry = allocation_tags::detail::site_cache[
+        (reinterpret_cast<std::uintptr_t>(site.file) / 8 + site.line) % 64];
+    if (entry.file == site.file && entry.line == site.line) {
+        return allocation_tag(entry.id);
+    }
+    try {
+        std::string name = site.file;
+        std::size_t slash = name.find_last_of("/\\");
+        if (slash != std::string::npos) name.erase(0, slash + 1);
+        name += ":" + std::to_string(site.line) + " " + site.function;
+        allocation_tag tag(allocation_tags::detail::registry::instance().intern(name));
+        entry = {site.file, site.line, tag.id()};
+        return tag;
+    } catch (...) {
+        return allocation_tag(overflow_id);
+    }
+}
+
+inline const char* allocation_tag::name() const noexcept {
+    if (id_ == overflow_id) return "(other)";
+    try {
+        auto& r = allocation_tags::detail::registry::instance();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        return id_ < r.names.size() ? r.names[id_].c_str() : "?";
+    } catch (...) {
+        return "?";
+    }
+}
+
+#endif
@@ -0,0 +1,267 @@
+#ifndef ALLOCATION_TRACE_H
+#define ALLOCATION_TRACE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Переключатель трассировки: -DMY_ALLOCATOR_TRACE=1 встраивает запись
+// allocate/deallocate в my_allocator. Сама запись включается во время
+// выполнения через allocation_trace::start()
+#ifndef MY_ALLOCATOR_TRACE
+#define MY_ALLOCATOR_TRACE 0
+#endif
+
+namespace allocation_trace {
+
+// Формат файла: заголовок, затем записи фиксированного размера подряд.
+// Записи разных потоков идут блоками, упорядочивать по timestamp_ns
+// должен читатель. Версия 2 - 64-битный размер блока; файлы версии 1
+// (32-битный размер) load() тоже читает
+constexpr char file_magic[4] = {'A', 'L', 'T', 'R'};
+constexpr std::uint32_t file_version = 2;
+
+enum class op : std::uint8_t {
+    allocate = 1,
+    deallocate = 2,
+};
+
+#pragma pack(push, 1)
+struct file_header {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t record_size;
+};
+
+struct record {
+    std::uint64_t timestamp_ns;  // От момента start()
+    std::uint64_t address;       // Адрес блока - идентификатор для сопоставления пар
+    std::uint64_t size;          // Размер в байтах
+    std::uint16_t thread;        // Порядковый номер потока в трассе
+    std::uint8_t kind;           // op
+    std::uint8_t reserved;
+};
+
+// Запись версии 1
+struct record_v1 {
+    std::uint64_t timestamp_ns;
+    std::uint64_t address;
+    std::uint32_t size;
+    std::uint16_t thread;
+    std::uint8_t kind;
+    std::uint8_t reserved;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(record) == 28, "Запись трассы должна оставаться компактной");
+static_assert(sizeof(record_v1) == 24, "Формат версии 1 не меняется");
+
+namespace detail {
+
+// Кольцевой буфер потока: пишет только поток-владелец, забирает запись
+// в файл тот, кто держит file_mutex (сам владелец при переполнении
+// или flush() из любого потока)
+struct ring {
+    explicit ring(std::size_t capacity, std::uint16_t id)
+        : records(new record[capacity]), capacity(capacity), thread(id) {}
+
+    std::unique_ptr<record[]> records;
+    std::size_t capacity;
+    std::uint16_t thread;
+    std::atomic<std::size_t> head{0};  // Следующая позиция записи
+    std::atomic<std::size_t> tail{0};  // Первая невыгруженная запись
+};
+
+struct state {
+    std::mutex file_mutex;             // Файл и список буферов
+    std::FILE* file = nullptr;
+    std::vector<ring*> rings;
+    std::size_t ring_capacity = 0;
+    std::chrono::steady_clock::time_point origin;
+    std::atomic<bool> enabled{false};
+    std::atomic<std::uint32_t> generation{0};  // Меняется при каждом start()
+
+    static state& instance() {
+        static state* s = new state();  // Не разрушается: потоки могут писать после main
+        return *s;
+    }
+};
+
+// Выгрузка накопленного в файл; вызывается под file_mutex
+inline void drain(state& s, ring& r) {
+    std::size_t tail = r.tail.load(std::memory_order_relaxed);
+    std::size_t head = r.head.load(std::memory_order_acquire);
+    while (tail != head) {
+        std::size_t begin = tail % r.capacity;
+        std::size_t count = std::min(head - tail, r.capacity - begin);
+        if (s.file) {
+            std::fwrite(r.records.get() + begin, sizeof(record), count, s.file);
+        }
+        tail += count;
+    }
+    r.tail.store(tail, std::memory_order_release);
+}
+
+struct thread_ring {
+    ring* current = nullptr;
+    std::uint32_t generation = 0;
+};
+
+inline thread_local thread_ring tls_ring;
+
+inline ring* attach(state& s) {
+    std::lock_guard<std::mutex> lock(s.file_mutex);
+    if (!s.enabled.load(std::memory_order_relaxed)) return nullptr;
+    ring* r = new ring(s.ring_capacity, static_cast<std::uint16_t>(s.rings.size()));
+    s.rings.push_back(r);
+    tls_ring.current = r;
+    tls_ring.generation = s.generation.load(std::memory_order_relaxed);
+    return r;
+}
+
+inline void write(op kind, const void* p, std::size_t bytes) {
+    state& s = state::instance();
+    ring* r = tls_ring.current;
+    // Буфер от прошлой сессии трассировки уже удален в stop()
+    if (!r || tls_ring.generation != s.generation.load(std::memory_order_relaxed)) {
+        r = attach(s);
+        if (!r) return;
+    }
+
+    std::size_t head = r->head.load(std::memory_order_relaxed);
+    if (head - r->tail.load(std::memory_order_acquire) == r->capacity) {
+        // Буфер полон - выгружаем сами
+        std::lock_guard<std::mutex> lock(s.file_mutex);
+        drain(s, *r);
+    }
+
+    record& rec = r->records[head % r->capacity];
+    rec.timestamp_ns = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - s.origin).count());
+    rec.address = reinterpret_cast<std::uintptr_t>(p);
+    rec.size = static_cast<std::uint64_t>(bytes);
+    rec.thread = r->thread;
+    rec.kind = static_cast<std::uint8_t>(kind);
+    rec.reserved = 0;
+    r->head.store(head + 1, std::memory_order_release);
+}
+
+} // namespace detail
+
+inline bool enabled() noexcept {
+    return detail::state::instance().enabled.load(std::memory_order_relaxed);
+}
+
+// Начало записи в файл path. ring_capacity - записей в буфере каждого потока
+inline bool start(const char* path, std::size_t ring_capacity = 1 << 16) {
+    detail::state& s = detail::state::instance();
+    std::lock_guard<std::mutex> lock(s.file_mutex);
+    if (s.file) return false;
+    s.file = std::fopen(path, "wb");
+    if (!s.file) return false;
+
+    file_header header;
+    std::memcpy(header.magic, file_magic, sizeof(header.magic));
+    header.version = file_version;
+    header.record_size = sizeof(record);
+    std::fwrite(&header, sizeof(header), 1, s.file);
+
+    s.ring_capacity = ring_capacity;
+    s.origin = std::chrono::steady_clock::now();
+    s.generation.fetch_add(1, std::memory_order_relaxed);
+    s.enabled.store(true, std::memory_order_release);
+    return true;
+}
+
+// Выгрузка буферов всех потоков без остановки записи
+inline void flush() {
+    detail::state& s = detail::state::instance();
+    std::lock_guard<std::mutex> lock(s.file_mutex);
+    for (auto* r : s.rings) {
+        detail::drain(s, *r);
+    }
+    if (s.file) std::fflush(s.file);
+}
+
+// Остановка: выгружает все буферы и закрывает файл. Потоки, которые
+// в этот момент еще внутри allocate, должны быть остановлены заранее
+inline void stop() {
+    detail::state& s = detail::state::instance();
+    std::lock_guard<std::mutex> lock(s.file_mutex);
+    if (!s.file) return;
+    s.enabled.store(false, std::memory_order_release);
+    for (auto* r : s.rings) {
+        detail::drain(s, *r);
+        delete r;
+    }
+    s.rings.clear();
+    std::fclose(s.file);
+    s.file = nullptr;
+}
+
+// Точки записи для my_allocator. Не бросают: при нехватке памяти
+// под буфер потока запись просто теряется
+inline void record_allocate(const void* p, std::size_t bytes) noexcept {
+    if (!enabled()) return;
+    try {
+        detail::write(op::allocate, p, bytes);
+    } catch (...) {
+    }
+}
+
+inline void record_deallocate(const void* p, std::size_t bytes) noexcept {
+    if (!enabled()) return;
+    try {
+        detail::write(op::deallocate, p, bytes);
+    } catch (...) {
+    }
+}
+
+// Чтение трассы целиком; записи упорядочены по времени
+inline bool load(const char* path, std::vector<record>& out) {
+    std::FILE* file = std::fopen(path, "rb");
+    if (!file) return false;
+
+    file_header header;
+    bool ok = std::fread(&header, sizeof(header), 1, file) == 1 &&
+              std::memcmp(header.magic, file_magic, sizeof(header.magic)) == 0 &&
+              ((header.version == file_version && header.record_size == sizeof(record)) ||
+               (header.version == 1 && header.record_size == sizeof(record_v1)));
+    if (ok && header.version == file_version) {
+        record rec;
+        while (std::fread(&rec, sizeof(rec), 1, file) == 1) {
+            out.push_back(rec);
+        }
+    } else if (ok) {
+        record_v1 old;
+        while (std::fread(&old, sizeof(old), 1, file) == 1) {
+            record rec;
+            rec.timestamp_ns = old.timestamp_ns;
+            rec.address = old.address;
+            rec.size = old.size;
+            rec.thread = old.thread;
+            rec.kind = old.kind;
+            rec.reserved = 0;
+            out.push_back(rec);
+        }
+    }
+    std::fclose(file);
+    if (!ok) return false;
+
+    std::stable_sort(out.begin(), out.end(), [](const record& a, const record& b) {
+        return a.timestamp_ns < b.timestamp_ns;
+    });
+    return true;
+}
+
+} // namespace allocation_trace
+
+#endif
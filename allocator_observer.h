@@ -0,0 +1,147 @@
+#ifndef ALLOCATOR_OBSERVER_H
+#define ALLOCATOR_OBSERVER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+// Переключатель наблюдателей: -DMY_ALLOCATOR_OBSERVER=1 встраивает вызовы
+// наблюдателей в медленные пути my_allocator (новый чанк, освобождение,
+// нехватка памяти). Быстрый путь allocate/deallocate их не вызывает
+#ifndef MY_ALLOCATOR_OBSERVER
+#define MY_ALLOCATOR_OBSERVER 0
+#endif
+
+// Событие жизненного цикла арены
+struct allocator_event {
+    const void* arena = nullptr;    // Арена my_allocator (общая для копий)
+    std::size_t slot_size = 0;      // sizeof(T) арены
+    const void* address = nullptr;  // Начало чанка (acquire/release), иначе nullptr
+    std::size_t bytes = 0;          // Байты чанка или запроса
+    std::size_t chunks = 0;         // Чанков в арене после события
+};
+
+// Наблюдатель: переопределяются нужные методы. Вызовы идут из потока,
+// выполняющего операцию, под общим mutex наблюдателей, но уже без
+// блокировки арены; добавлять и удалять наблюдателей из обработчика
+// нельзя. Аллокации через my_allocator внутри обработчика допустимы,
+// в том числе через ту же арену; вложенные события не доставляются
+class allocator_observer {
+public:
+    virtual ~allocator_observer() = default;
+
+    virtual void on_chunk_acquire(const allocator_event&) {}
+    virtual void on_chunk_release(const allocator_event&) {}
+    // allocate не нашел места в существующих чанках; bytes - запрос
+    virtual void on_slow_path(const allocator_event&) {}
+    // Память под чанк не выделена; следом allocate бросит bad_alloc
+    virtual void on_oom(const allocator_event&) {}
+    // Арена вернула свободные чанки; bytes - возвращенные байты
+    virtual void on_trim(const allocator_event&) {}
+};
+
+namespace allocator_observers {
+
+namespace detail {
+
+struct registry {
+    std::mutex mutex;
+    std::vector<allocator_observer*> observers;
+
+    static registry& instance() {
+        static registry* r = new registry();  // Не разрушается: арены освобождаются и после main
+        return *r;
+    }
+};
+
+inline std::atomic<bool> any{false};
+inline thread_local bool notifying = false;
+
+// События, отложенные до снятия блокировки арены. Одна операция
+// allocate дает не больше трех: slow_path и затем acquire или oom
+using handler_type = void (allocator_observer::*)(const allocator_event&);
+
+struct pending_event {
+    handler_type handler = nullptr;
+    allocator_event event;
+};
+
+constexpr std::size_t max_pending = 4;
+inline thread_local pending_event pending[max_pending];
+inline thread_local std::size_t pending_count = 0;
+// Заходил ли поток в очередь отложенных событий: аллокаторы без
+// Policy::tracing не должны ее касаться
+inline thread_local bool deferred_used = false;
+
+} // namespace detail
+
+// Наблюдатель должен жить до remove (или до конца программы)
+inline void add(allocator_observer* observer) {
+    auto& r = detail::registry::instance();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.observers.push_back(observer);
+    detail::any.store(true, std::memory_order_release);
+}
+
+inline void remove(allocator_observer* observer) {
+    auto& r = detail::registry::instance();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.observers.erase(std::remove(r.observers.begin(), r.observers.end(), observer), r.observers.end());
+    detail::any.store(!r.observers.empty(), std::memory_order_release);
+}
+
+// Доставка события всем наблюдателям; исключения обработчиков гасятся,
+// чтобы не ломать освобождение и деструкторы
+template <typename Handler>
+void notify(Handler handler, const allocator_event& event) noexcept {
+    if (!detail::any.load(std::memory_order_acquire) || detail::notifying) return;
+    detail::notifying = true;
+    try {
+        auto& r = detail::registry::instance();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (allocator_observer* observer : r.observers) {
+            try {
+                (observer->*handler)(event);
+            } catch (...) {
+            }
+        }
+    } catch (...) {
+    }
+    detail::notifying = false;
+}
+
+// Событие под блокировкой арены: запоминается в потоке и доставляется
+// deferred_scope после ее снятия, чтобы обработчик мог выделять память
+// через ту же арену
+inline void defer(detail::handler_type handler, const allocator_event& event) noexcept {
+    if (!detail::any.load(std::memory_order_acquire) || detail::notifying) return;
+    detail::deferred_used = true;
+    if (detail::pending_count < detail::max_pending) detail::pending[detail::pending_count++] = {handler, event};
+}
+
+// Доставка отложенных событий потока; очередь освобождается до вызова
+// обработчиков, вложенные операции в них начинают с пустой
+inline void deliver_deferred() noexcept {
+    std::size_t count = detail::pending_count;
+    if (count == 0) return;
+    detail::pending_event events[detail::max_pending];
+    std::copy(detail::pending, detail::pending + count, events);
+    detail::pending_count = 0;
+    for (std::size_t i = 0; i < count; ++i) notify(events[i].handler, events[i].event);
+}
+
+// Объявляется до блокировки арены: разрушается после нее, в том числе
+// при исключении (on_oom доставляется до того, как bad_alloc уйдет выше)
+class deferred_scope {
+public:
+    deferred_scope() noexcept { detail::deferred_used = true; }
+    deferred_scope(const deferred_scope&) = delete;
+    deferred_scope& operator=(const deferred_scope&) = delete;
+    ~deferred_scope() { deliver_deferred(); }
+};
+
+} // namespace allocator_observers
+
+#endif
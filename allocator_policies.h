@@ -0,0 +1,95 @@
+#ifndef ALLOCATOR_POLICIES_H
+#define ALLOCATOR_POLICIES_H
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+// Политики my_allocator: третий параметр шаблона собирает их в одну
+// структуру. Свою конфигурацию удобно наследовать от готовой:
+//
+//     struct page_policy : default_allocator_policy {
+//         using growth = geometric_growth<6>;
+//         static constexpr std::size_t alignment = 4096;
+//     };
+//     my_allocator<node, 64, page_policy> alloc;
+//
+// Макросы MY_ALLOCATOR_* задают, что вообще собрано в программу;
+// политика решает, что из собранного использует конкретный аллокатор.
+// Выключенная политика убирает свой код через if constexpr и пустые
+// типы, поэтому быстрый путь minimal_allocator_policy тот же, что у
+// аллокатора без средств наблюдения
+
+// Мьютекс, который ничего не делает: блокировки компилируются в ноль
+struct null_mutex {
+    void lock() noexcept {}
+    void unlock() noexcept {}
+    bool try_lock() noexcept { return true; }
+};
+
+// Многопоточность: тип блокировки арены
+struct single_threaded {
+    using mutex_type = null_mutex;
+};
+
+// Копии одного аллокатора можно использовать из разных потоков
+struct mutex_threaded {
+    using mutex_type = std::mutex;
+};
+
+// Источник памяти чанков: operator new, с выравниванием при необходимости
+struct heap_chunk_source {
+    static void* allocate(std::size_t bytes, std::size_t alignment) {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            return operator new(bytes, std::align_val_t(alignment));
+        }
+        return operator new(bytes);
+    }
+
+    static void release(void* p, std::size_t bytes, std::size_t alignment) noexcept {
+        (void)bytes;
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            operator delete(p, std::align_val_t(alignment));
+        } else {
+            operator delete(p);
+        }
+    }
+};
+
+// Рост: размер следующего чанка в элементах по базовому ChunkSize
+// и числу уже выделенных чанков. Запрос больше результата получает
+// чанк ровно под себя
+struct fixed_growth {
+    static std::size_t next_chunk(std::size_t base, std::size_t chunks) noexcept {
+        (void)chunks;
+        return base;
+    }
+};
+
+// Удвоение с каждым чанком, не больше base << MaxDoublings
+template <std::size_t MaxDoublings = 10>
+struct geometric_growth {
+    static std::size_t next_chunk(std::size_t base, std::size_t chunks) noexcept {
+        return base << std::min(chunks, MaxDoublings);
+    }
+};
+
+// Конфигурация по умолчанию: все, что включено макросами
+struct default_allocator_policy {
+    using threading = single_threaded;
+    using chunk_source = heap_chunk_source;
+    using growth = fixed_growth;
+    static constexpr std::size_t alignment = 0;  // Выравнивание чанка; 0 - alignof(T)
+    static constexpr bool statistics = true;     // Счетчики (при MY_ALLOCATOR_STATS)
+    static constexpr bool tracing = true;        // Трасса, профили, теги, точки USDT,
+                                                 // наблюдатели, снимки, охрана бюджета
+};
+
+// Голая арена: только выделение из чанков и список свободных слотов
+struct minimal_allocator_policy : default_allocator_policy {
+    static constexpr bool statistics = false;
+    static constexpr bool tracing = false;
+};
+
+#endif
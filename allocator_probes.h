@@ -0,0 +1,53 @@
+#ifndef ALLOCATOR_PROBES_H
+#define ALLOCATOR_PROBES_H
+
+// Статические точки трассировки USDT (sys/sdt.h) провайдера allocator_lab.
+// Неподключенная точка - одна инструкция NOP (аргументы - уже лежащие
+// в регистрах значения), поэтому точки включены по умолчанию и выключаются
+// только -DMY_ALLOCATOR_PROBES=0. Без sys/sdt.h (не Linux, нет пакета
+// systemtap-sdt-dev) макросы пустые; MY_ALLOCATOR_PROBES_REQUIRED=1
+// (CMake: ALLOCATOR_LAB_REQUIRE_PROBES) превращает это в ошибку сборки.
+//
+// Точки и аргументы:
+//   allocate(arena, address, bytes, chunk)    chunk - номер чанка, -1 для слота из списка свободных
+//   deallocate(arena, address, bytes)
+//   chunk_acquire(arena, chunk, base, bytes)
+//   chunk_release(arena, chunk, base, bytes)
+//   trim(arena, chunks, bytes)                возврат памяти арены системе
+//   push_back(container, node, size)          size - после вставки
+//   clear(container, count)
+//
+// Пример: bpftrace -e 'usdt:./allocator_lab:allocator_lab:allocate { @[arg2] = count(); }'
+#ifndef MY_ALLOCATOR_PROBES
+#define MY_ALLOCATOR_PROBES 1
+#endif
+
+#if MY_ALLOCATOR_PROBES && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define ALLOCATOR_PROBES_ENABLED 1
+#endif
+#endif
+
+#ifndef ALLOCATOR_PROBES_ENABLED
+#define ALLOCATOR_PROBES_ENABLED 0
+#endif
+
+// Сборка, которая должна содержать точки (CI, ALLOCATOR_LAB_REQUIRE_PROBES),
+// не может молча получить пустые макросы
+#if defined(MY_ALLOCATOR_PROBES_REQUIRED) && MY_ALLOCATOR_PROBES_REQUIRED && !ALLOCATOR_PROBES_ENABLED
+#error "MY_ALLOCATOR_PROBES_REQUIRED: нет sys/sdt.h (пакет systemtap-sdt-dev) или MY_ALLOCATOR_PROBES=0"
+#endif
+
+#if ALLOCATOR_PROBES_ENABLED
+#define ALLOCATOR_PROBE2(name, a1, a2) DTRACE_PROBE2(allocator_lab, name, a1, a2)
+#define ALLOCATOR_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(allocator_lab, name, a1, a2, a3)
+#define ALLOCATOR_PROBE4(name, a1, a2, a3, a4) DTRACE_PROBE4(allocator_lab, name, a1, a2, a3, a4)
+#else
+// Аргументы только помечаются использованными, код для них не остается
+#define ALLOCATOR_PROBE2(name, a1, a2) do { (void)(a1); (void)(a2); } while (0)
+#define ALLOCATOR_PROBE3(name, a1, a2, a3) do { (void)(a1); (void)(a2); (void)(a3); } while (0)
+#define ALLOCATOR_PROBE4(name, a1, a2, a3, a4) do { (void)(a1); (void)(a2); (void)(a3); (void)(a4); } while (0)
+#endif
+
+#endif
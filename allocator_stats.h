@@ -0,0 +1,153 @@
+#ifndef ALLOCATOR_STATS_H
+#define ALLOCATOR_STATS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Переключатель статистики: -DMY_ALLOCATOR_STATS=0 полностью убирает
+// счетчики из my_allocator (поля и код на горячем пути)
+#ifndef MY_ALLOCATOR_STATS
+#define MY_ALLOCATOR_STATS 1
+#endif
+
+// Снимок состояния аллокатора, возвращаемый my_allocator::stats()
+struct allocator_stats {
+    std::size_t allocate_calls = 0;     // Количество вызовов allocate
+    std::size_t deallocate_calls = 0;   // Количество вызовов deallocate
+    std::size_t live_bytes = 0;         // Выдано и еще не возвращено (байты)
+    std::size_t live_slots = 0;         // То же в элементах типа T
+    std::size_t chunk_count = 0;        // Количество чанков
+    std::size_t reserved_bytes = 0;     // Память, запрошенная у системы под чанки
+    std::size_t used_bytes = 0;         // Занятая часть чанков (до указателя used)
+    std::size_t free_bytes = 0;         // Освобожденные слоты в ожидании повторного выделения
+    std::size_t high_water_bytes = 0;   // Максимум live_bytes за время жизни
+    std::size_t wasted_tail_bytes = 0;  // Хвосты закрытых чанков, куда не влез запрос
+
+    // Доля зарезервированной памяти, не занятой живыми объектами
+    double fragmentation() const noexcept {
+        if (reserved_bytes == 0) return 0.0;
+        return 1.0 - static_cast<double>(live_bytes) / static_cast<double>(reserved_bytes);
+    }
+
+    // Средний потерянный хвост на чанк
+    double wasted_tail_per_chunk() const noexcept {
+        if (chunk_count == 0) return 0.0;
+        return static_cast<double>(wasted_tail_bytes) / static_cast<double>(chunk_count);
+    }
+};
+
+// Суммарная статистика по всем экземплярам my_allocator в процессе
+struct global_allocator_stats {
+    std::uint64_t allocate_calls = 0;
+    std::uint64_t deallocate_calls = 0;
+    std::uint64_t allocated_bytes = 0;     // Всего выдано
+    std::uint64_t deallocated_bytes = 0;   // Всего возвращено
+    std::uint64_t chunks_acquired = 0;
+    std::uint64_t chunks_released = 0;
+    std::uint64_t chunk_bytes_acquired = 0;
+    std::uint64_t chunk_bytes_released = 0;
+
+    std::uint64_t live_bytes() const noexcept { return allocated_bytes - deallocated_bytes; }
+    std::uint64_t reserved_bytes() const noexcept { return chunk_bytes_acquired - chunk_bytes_released; }
+};
+
+namespace allocator_stats_detail {
+
+// Блок счетчиков одного потока. Пишет только поток-владелец (load + store
+// без RMW, на x86 это обычные mov), читает агрегатор - поэтому atomic
+// с relaxed, а не блокировки
+struct thread_counters {
+    std::atomic<std::uint64_t> allocate_calls{0};
+    std::atomic<std::uint64_t> deallocate_calls{0};
+    std::atomic<std::uint64_t> allocated_bytes{0};
+    std::atomic<std::uint64_t> deallocated_bytes{0};
+    std::atomic<std::uint64_t> chunks_acquired{0};
+    std::atomic<std::uint64_t> chunks_released{0};
+    std::atomic<std::uint64_t> chunk_bytes_acquired{0};
+    std::atomic<std::uint64_t> chunk_bytes_released{0};
+};
+
+inline void bump(std::atomic<std::uint64_t>& counter, std::uint64_t delta) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+inline void accumulate(global_allocator_stats& out, const thread_counters& c) noexcept {
+    out.allocate_calls += c.allocate_calls.load(std::memory_order_relaxed);
+    out.deallocate_calls += c.deallocate_calls.load(std::memory_order_relaxed);
+    out.allocated_bytes += c.allocated_bytes.load(std::memory_order_relaxed);
+    out.deallocated_bytes += c.deallocated_bytes.load(std::memory_order_relaxed);
+    out.chunks_acquired += c.chunks_acquired.load(std::memory_order_relaxed);
+    out.chunks_released += c.chunks_released.load(std::memory_order_relaxed);
+    out.chunk_bytes_acquired += c.chunk_bytes_acquired.load(std::memory_order_relaxed);
+    out.chunk_bytes_released += c.chunk_bytes_released.load(std::memory_order_relaxed);
+}
+
+// Реестр блоков счетчиков. Блоки не освобождаются: после завершения
+// потока блок помечается свободным и достается следующему потоку.
+// Значения в нем накопительные, поэтому сумма по всем блокам остается верной
+struct registry {
+    std::mutex mutex;
+    std::vector<thread_counters*> blocks;
+    std::vector<thread_counters*> free_blocks;
+
+    static registry& instance() {
+        static registry* r = new registry();  // Не разрушается: потоки могут завершаться после main
+        return *r;
+    }
+};
+
+inline thread_local thread_counters* tls_counters = nullptr;
+
+// Возвращает блок потока в реестр при завершении потока
+struct thread_slot {
+    ~thread_slot() {
+        registry& r = registry::instance();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.free_blocks.push_back(tls_counters);
+        tls_counters = nullptr;
+    }
+};
+
+inline thread_counters& attach() {
+    registry& r = registry::instance();
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        if (!r.free_blocks.empty()) {
+            tls_counters = r.free_blocks.back();
+            r.free_blocks.pop_back();
+        } else {
+            tls_counters = new thread_counters();
+            r.blocks.push_back(tls_counters);
+        }
+    }
+    // После разрушения slot (поздние вызовы при выходе потока) блок
+    // просто остается занятым
+    thread_local thread_slot slot;
+    (void)slot;
+    return *tls_counters;
+}
+
+// Быстрый путь - одна проверка тривиального thread_local указателя
+inline thread_counters& local() {
+    thread_counters* counters = tls_counters;
+    if (counters) return *counters;
+    return attach();
+}
+
+} // namespace allocator_stats_detail
+
+// Ленивая агрегация: суммирует блоки всех потоков только при запросе
+inline global_allocator_stats allocator_global_stats() {
+    auto& r = allocator_stats_detail::registry::instance();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    global_allocator_stats result;
+    for (const auto* counters : r.blocks) {
+        allocator_stats_detail::accumulate(result, *counters);
+    }
+    return result;
+}
+
+#endif
@@ -0,0 +1,358 @@
+// Микробенчмарки горячих путей my_allocator и my_container.
+// Использование: allocator_bench [--n=N] [--warmup=N] [--reps=N]
+//                                [--filter=S] [--json[=path]] [--list] [--no-perf]
+//                allocator_bench --scaling ... (см. scaling_bench.cpp)
+//                allocator_bench --locality ... (см. locality_bench.cpp)
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+#include "bench_harness.h"
+#include "locality_bench.h"
+#include "my_allocator.h"
+#include "my_container.h"
+#include "scaling_bench.h"
+
+namespace {
+
+template <typename T>
+struct type_tag {
+    using type = T;
+};
+
+// Объект заданного размера для бенчмарков allocate
+template <std::size_t Size>
+struct payload {
+    unsigned char bytes[Size];
+};
+
+template <typename Alloc>
+struct backend_name;
+
+template <typename T>
+struct backend_name<std::allocator<T>> {
+    static std::string get() { return "std"; }
+};
+
+template <typename T, std::size_t ChunkSize>
+struct backend_name<my_allocator<T, ChunkSize>> {
+    static std::string get() { return "my_allocator<" + std::to_string(ChunkSize) + ">"; }
+};
+
+// Все сравниваемые аллокаторы для типа T
+template <typename T, typename F>
+void for_each_backend(F&& f) {
+    f(type_tag<std::allocator<T>>{});
+    f(type_tag<my_allocator<T, 16>>{});
+    f(type_tag<my_allocator<T, 256>>{});
+    f(type_tag<my_allocator<T, 4096>>{});
+}
+
+template <typename Alloc>
+std::string label(const std::string& group, type_tag<Alloc>) {
+    return group + "/" + backend_name<Alloc>::get();
+}
+
+// allocate(1) + deallocate для n объектов; аллокатор создается
+// и разрушается вне измерения
+template <std::size_t Size>
+void bench_allocate(bench::runner& runner, std::size_t n) {
+    using T = payload<Size>;
+    for_each_backend<T>([&](auto tag) {
+        using Alloc = typename decltype(tag)::type;
+        std::vector<T*> pointers(n);
+        runner.run(label("allocate_deallocate/size=" + std::to_string(Size), tag), n,
+                   [&](bench::timer& t) {
+            t.pause();
+            auto alloc = std::make_unique<Alloc>();
+            t.resume();
+            for (std::size_t i = 0; i < n; ++i) {
+                pointers[i] = alloc->allocate(1);
+            }
+            bench::clobber_memory();
+            for (std::size_t i = 0; i < n; ++i) {
+                alloc->deallocate(pointers[i], 1);
+            }
+            t.pause();
+            alloc.reset();
+            t.resume();
+        });
+    });
+}
+
+// Заполнение n объектов и полный демонтаж, включая разрушение аллокатора
+template <std::size_t Size>
+void bench_fill_teardown(bench::runner& runner, std::size_t n) {
+    using T = payload<Size>;
+    for_each_backend<T>([&](auto tag) {
+        using Alloc = typename decltype(tag)::type;
+        using traits = std::allocator_traits<Alloc>;
+        std::vector<T*> pointers(n);
+        runner.run(label("fill_teardown/size=" + std::to_string(Size), tag), n,
+                   [&](bench::timer&) {
+            Alloc alloc;
+            for (std::size_t i = 0; i < n; ++i) {
+                pointers[i] = traits::allocate(alloc, 1);
+                traits::construct(alloc, pointers[i]);
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                traits::destroy(alloc, pointers[i]);
+                traits::deallocate(alloc, pointers[i], 1);
+            }
+        });
+    });
+}
+
+// Эталон для политик: алгоритм арены my_allocator (первый подходящий
+// чанк, список свободных одиночных слотов) без политик и семейства арен.
+// Быстрый путь my_allocator с minimal_allocator_policy не должен от него отставать
+template <typename T, std::size_t ChunkSize>
+class bump_reference {
+public:
+    using value_type = T;
+
+    bump_reference() = default;
+    bump_reference(const bump_reference&) = delete;
+    bump_reference& operator=(const bump_reference&) = delete;
+
+    ~bump_reference() {
+        for (const chunk& c : chunks_) operator delete(c.data);
+    }
+
+    T* allocate(std::size_t n) {
+        if (n == 1 && free_list_) {
+            void* slot = free_list_;
+            std::memcpy(&free_list_, slot, sizeof(void*));
+            return static_cast<T*>(slot);
+        }
+        T* result = nullptr;
+        for (std::size_t i = first_open_; i < chunks_.size(); ++i) {
+            if (chunks_[i].size - chunks_[i].used >= n) {
+                result = chunks_[i].data + chunks_[i].used;
+                chunks_[i].used += n;
+                break;
+            }
+        }
+        if (!result) result = allocate_chunk(n);
+        while (first_open_ < chunks_.size() && chunks_[first_open_].used == chunks_[first_open_].size) {
+            ++first_open_;
+        }
+        return result;
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        static_assert(sizeof(T) >= sizeof(void*), "слот должен вмещать указатель");
+        if (n == 1 && p) {
+            std::memcpy(static_cast<void*>(p), &free_list_, sizeof(void*));
+            free_list_ = p;
+        }
+    }
+
+private:
+    MY_ALLOCATOR_COLD T* allocate_chunk(std::size_t n) {
+        std::size_t size = std::max(ChunkSize, n);
+        T* result = static_cast<T*>(operator new(size * sizeof(T)));
+        try {
+            chunks_.push_back({result, size, n});
+        } catch (...) {
+            operator delete(result);
+            throw;
+        }
+        return result;
+    }
+
+    struct chunk {
+        T* data;
+        std::size_t size;
+        std::size_t used;
+    };
+    std::vector<chunk> chunks_;
+    void* free_list_ = nullptr;
+    std::size_t first_open_ = 0;
+};
+
+// Цена политик на быстром пути: эталон, все выключено, конфигурация по умолчанию.
+// Что minimal не заходит в статистику и средства наблюдения, проверяет
+// tests/policy_test.cpp; здесь - только цена
+template <std::size_t Size>
+void bench_policies(bench::runner& runner, std::size_t n) {
+    using T = payload<Size>;
+    std::vector<T*> pointers(n);
+    auto churn = [&](auto& alloc) {
+        for (std::size_t i = 0; i < n; ++i) pointers[i] = alloc.allocate(1);
+        bench::clobber_memory();
+        for (std::size_t i = 0; i < n; ++i) alloc.deallocate(pointers[i], 1);
+    };
+    auto run = [&](const std::string& backend, auto make) {
+        runner.run("policy/allocate_deallocate/size=" + std::to_string(Size) + "/" + backend, n,
+                   [&](bench::timer& t) {
+            t.pause();
+            auto alloc = make();
+            churn(*alloc);  // Чанки уже есть: измеряется только быстрый путь
+            t.resume();
+            churn(*alloc);
+            t.pause();
+            alloc.reset();
+            t.resume();
+        });
+    };
+    run("reference", [] { return std::make_unique<bump_reference<T, 4096>>(); });
+    run("minimal", [] { return std::make_unique<my_allocator<T, 4096, minimal_allocator_policy>>(); });
+    run("default", [] { return std::make_unique<my_allocator<T, 4096>>(); });
+}
+
+std::vector<int> shuffled_keys(std::size_t n) {
+    std::vector<int> keys(n);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+    return keys;
+}
+
+void bench_map(bench::runner& runner, std::size_t n) {
+    const std::vector<int> keys = shuffled_keys(n);
+    for_each_backend<std::pair<const int, int>>([&](auto tag) {
+        using Alloc = typename decltype(tag)::type;
+        using map_type = std::map<int, int, std::less<int>, Alloc>;
+
+        runner.run(label("map_insert", tag), n, [&](bench::timer& t) {
+            auto map = std::make_unique<map_type>();
+            for (int key : keys) map->emplace(key, key);
+            t.pause();
+            map.reset();
+            t.resume();
+        });
+
+        runner.run(label("map_find", tag), n, [&](bench::timer& t) {
+            t.pause();
+            auto map = std::make_unique<map_type>();
+            for (int key : keys) map->emplace(key, key);
+            t.resume();
+            long sum = 0;
+            for (int key : keys) sum += map->find(key)->second;
+            bench::do_not_optimize(sum);
+            t.pause();
+            map.reset();
+            t.resume();
+        });
+
+        runner.run(label("map_erase", tag), n, [&](bench::timer& t) {
+            t.pause();
+            auto map = std::make_unique<map_type>();
+            for (int key : keys) map->emplace(key, key);
+            t.resume();
+            for (int key : keys) map->erase(key);
+            t.pause();
+            map.reset();
+            t.resume();
+        });
+    });
+}
+
+// Заполнение и обход my_container; NodeCapacity > 1 - развернутый список
+template <std::size_t NodeCapacity>
+void bench_container(bench::runner& runner, std::size_t n) {
+    const std::string suffix = NodeCapacity > 1 ? "/unrolled=" + std::to_string(NodeCapacity) : "";
+    for_each_backend<int>([&](auto tag) {
+        using Alloc = typename decltype(tag)::type;
+        using container_type = my_container<int, Alloc, NodeCapacity>;
+
+        runner.run(label("container_push_back" + suffix, tag), n, [&](bench::timer& t) {
+            auto container = std::make_unique<container_type>();
+            for (std::size_t i = 0; i < n; ++i) container->push_back(static_cast<int>(i));
+            t.pause();
+            container.reset();
+            t.resume();
+        });
+
+        runner.run(label("container_push_back_reserved" + suffix, tag), n, [&](bench::timer& t) {
+            t.pause();
+            auto container = std::make_unique<container_type>();
+            container->reserve(n);
+            t.resume();
+            for (std::size_t i = 0; i < n; ++i) container->push_back(static_cast<int>(i));
+            t.pause();
+            container.reset();
+            t.resume();
+        });
+
+        // Разрушение заполненного контейнера; для int над my_allocator
+        // без других копий аллокатора - освобождение чанков без обхода
+        runner.run(label("container_destroy" + suffix, tag), n, [&](bench::timer& t) {
+            t.pause();
+            auto container = std::make_unique<container_type>();
+            for (std::size_t i = 0; i < n; ++i) container->push_back(static_cast<int>(i));
+            t.resume();
+            container.reset();
+        });
+
+        // Цикл заполнение-очистка: с clear(true) узлы остаются в запасе
+        for (bool keep : {false, true}) {
+            container_type buffer;
+            runner.run(label(std::string("container_refill_") + (keep ? "keep" : "release") + suffix, tag), n,
+                       [&](bench::timer&) {
+                buffer.clear(keep);
+                for (std::size_t i = 0; i < n; ++i) buffer.push_back(static_cast<int>(i));
+            });
+        }
+
+        std::vector<int> values(n);
+        std::iota(values.begin(), values.end(), 0);
+        runner.run(label("container_append" + suffix, tag), n, [&](bench::timer& t) {
+            auto container = std::make_unique<container_type>();
+            container->append(values.begin(), values.end());
+            t.pause();
+            container.reset();
+            t.resume();
+        });
+
+        container_type container(values.begin(), values.end());
+        runner.run(label("container_iterate" + suffix, tag), n, [&](bench::timer&) {
+            long sum = 0;
+            for (int value : container) sum += value;
+            bench::do_not_optimize(sum);
+        });
+    });
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--scaling") {
+        return run_scaling_bench(std::vector<std::string>(argv + 2, argv + argc));
+    }
+    if (argc > 1 && std::string(argv[1]) == "--locality") {
+        return run_locality_bench(argc - 1, argv + 1);
+    }
+
+    bench::options options;
+    std::size_t n = 10000;
+    for (const auto& arg : options.parse(argc, argv)) {
+        if (arg.compare(0, 4, "--n=") == 0) {
+            n = std::max<std::size_t>(1, std::strtoul(arg.c_str() + 4, nullptr, 10));
+        } else {
+            std::cerr << "Ошибка: неизвестный аргумент " << arg << "\n";
+            return 1;
+        }
+    }
+
+    bench::runner runner(options);
+    bench_allocate<8>(runner, n);
+    bench_allocate<64>(runner, n);
+    bench_allocate<256>(runner, n);
+    bench_fill_teardown<8>(runner, n);
+    bench_fill_teardown<64>(runner, n);
+    bench_fill_teardown<256>(runner, n);
+    bench_policies<8>(runner, n);
+    bench_policies<64>(runner, n);
+    bench_map(runner, n);
+    bench_container<1>(runner, n);
+    bench_container<unrolled_capacity<int>>(runner, n);
+    return runner.finish() ? 0 : 1;
+}
@@ -0,0 +1,266 @@
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "perf_counters.h"
+
+// Минимальный харнесс микробенчмарков: прогрев, повторы,
+// медиана и MAD времени на операцию, вывод таблицей или JSON
+namespace bench {
+
+// Не дает компилятору выбросить вычисление результата
+template <typename T>
+inline void do_not_optimize(T const& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+inline void clobber_memory() {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+struct options {
+    std::size_t warmup = 3;        // Прогревочные прогоны, в статистику не входят
+    std::size_t repetitions = 15;  // Измеряемые прогоны
+    std::string filter;            // Подстрока имени; пусто - все бенчмарки
+    std::string json_path;         // Куда писать JSON; "-" - stdout
+    bool list_only = false;
+    bool perf = true;              // Счетчики perf_event_open, если доступны
+
+    // Разбор --warmup=N --reps=N --filter=S --json[=path] --list --no-perf;
+    // неизвестные аргументы оставляются вызывающему
+    std::vector<std::string> parse(int argc, char* argv[]) {
+        std::vector<std::string> rest;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&](const char* prefix) -> const char* {
+                std::size_t len = std::strlen(prefix);
+                return arg.compare(0, len, prefix) == 0 ? arg.c_str() + len : nullptr;
+            };
+            if (const char* v = value("--warmup=")) warmup = std::strtoul(v, nullptr, 10);
+            else if (const char* v = value("--reps=")) repetitions = std::max<std::size_t>(1, std::strtoul(v, nullptr, 10));
+            else if (const char* v = value("--filter=")) filter = v;
+            else if (const char* v = value("--json=")) json_path = v;
+            else if (arg == "--json") json_path = "-";
+            else if (arg == "--list") list_only = true;
+            else if (arg == "--no-perf") perf = false;
+            else rest.push_back(arg);
+        }
+        return rest;
+    }
+};
+
+// Управление таймером изнутри тела бенчмарка: подготовка и
+// очистка между повторами не должны попадать в измерение
+class timer {
+public:
+    // Вызовы ioctl счетчиков остаются вне замера: часы читаются до
+    // остановки счетчиков и после их запуска
+    void pause() {
+        paused_at_ = clock::now();
+        if (counters_) counters_->stop();
+    }
+
+    void resume() {
+        if (counters_) counters_->start();
+        excluded_ += clock::now() - paused_at_;
+    }
+
+private:
+    using clock = std::chrono::steady_clock;
+    clock::time_point paused_at_;
+    clock::duration excluded_{0};
+    perf_counters* counters_ = nullptr;  // Останавливаются вместе с таймером
+    friend class runner;
+};
+
+// Результат одного бенчмарка; время - наносекунды на операцию
+struct result {
+    std::string name;
+    std::size_t operations = 0;     // Операций в одном повторе
+    std::size_t repetitions = 0;
+    double median_ns = 0.0;
+    double mad_ns = 0.0;            // Медиана абсолютных отклонений от медианы
+    double min_ns = 0.0;
+    double max_ns = 0.0;
+    std::vector<std::pair<std::string, double>> counters;  // Дополнительные метрики на операцию
+};
+
+inline double median(std::vector<double> values) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    std::size_t mid = values.size() / 2;
+    return values.size() % 2 ? values[mid] : (values[mid - 1] + values[mid]) / 2.0;
+}
+
+inline double median_absolute_deviation(const std::vector<double>& values, double center) {
+    std::vector<double> deviations;
+    deviations.reserve(values.size());
+    for (double v : values) deviations.push_back(std::fabs(v - center));
+    return median(std::move(deviations));
+}
+
+class runner {
+public:
+    explicit runner(options opts) : options_(std::move(opts)) {
+        if (options_.perf && !options_.list_only) {
+            counters_ = std::make_unique<perf_counters>();
+            if (!counters_->available()) counters_.reset();
+        }
+    }
+
+    // Аппаратные счетчики недоступны (например, в VM) - только программные
+    bool hardware_counters() const { return counters_ && counters_->hardware(); }
+
+    // body(timer&) выполняет operations операций за один вызов
+    template <typename Body>
+    void run(const std::string& name, std::size_t operations, Body&& body) {
+        if (!options_.filter.empty() && name.find(options_.filter) == std::string::npos) return;
+        if (options_.list_only) {
+            std::cout << name << "\n";
+            return;
+        }
+
+        for (std::size_t i = 0; i < options_.warmup; ++i) {
+            timer t;
+            body(t);
+        }
+
+        std::vector<double> samples;
+        samples.reserve(options_.repetitions);
+        if (counters_) counters_->reset();
+        for (std::size_t i = 0; i < options_.repetitions; ++i) {
+            timer t;
+            t.counters_ = counters_.get();
+            if (counters_) counters_->start();
+            auto start = timer::clock::now();
+            body(t);
+            auto elapsed = timer::clock::now() - start - t.excluded_;
+            if (counters_) counters_->stop();
+            double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+            samples.push_back(ns / static_cast<double>(operations ? operations : 1));
+        }
+
+        result r;
+        r.name = name;
+        r.operations = operations;
+        r.repetitions = samples.size();
+        r.median_ns = median(samples);
+        r.mad_ns = median_absolute_deviation(samples, r.median_ns);
+        r.min_ns = *std::min_element(samples.begin(), samples.end());
+        r.max_ns = *std::max_element(samples.begin(), samples.end());
+        if (counters_) {
+            // Счетчики суммируются по всем повторам и делятся на все операции
+            double total_ops = static_cast<double>(operations ? operations : 1) * static_cast<double>(r.repetitions);
+            double cycles = 0.0, instructions = 0.0;
+            for (const auto& value : counters_->values()) {
+                r.counters.emplace_back(value.first + "_per_op", value.second / total_ops);
+                if (value.first == "cycles") cycles = value.second;
+                if (value.first == "instructions") instructions = value.second;
+            }
+            if (cycles > 0.0) r.counters.emplace_back("ipc", instructions / cycles);
+        }
+        print_row(r);
+        results_.push_back(std::move(r));
+    }
+
+    const std::vector<result>& results() const { return results_; }
+
+    // Печать JSON, если он был запрошен; возвращает false при ошибке записи
+    bool finish() const {
+        if (options_.json_path.empty() || options_.list_only) return true;
+        if (options_.json_path == "-") {
+            write_json(std::cout);
+            return true;
+        }
+        std::ofstream out(options_.json_path);
+        if (!out) {
+            std::cerr << "Ошибка: не удалось открыть " << options_.json_path << "\n";
+            return false;
+        }
+        write_json(out);
+        return static_cast<bool>(out);
+    }
+
+    void write_json(std::ostream& out) const {
+        out << "{\n  \"context\": {\"warmup\": " << options_.warmup
+            << ", \"repetitions\": " << options_.repetitions
+            << ", \"perf_counters\": \"" << (!counters_ ? "off" : counters_->hardware() ? "hardware" : "software")
+            << "\"},\n  \"benchmarks\": [";
+        for (std::size_t i = 0; i < results_.size(); ++i) {
+            const result& r = results_[i];
+            out << (i ? ",\n" : "\n") << "    {\"name\": \"" << escape(r.name) << "\""
+                << ", \"operations\": " << r.operations
+                << ", \"repetitions\": " << r.repetitions
+                << ", \"median_ns\": " << r.median_ns
+                << ", \"mad_ns\": " << r.mad_ns
+                << ", \"min_ns\": " << r.min_ns
+                << ", \"max_ns\": " << r.max_ns;
+            for (const auto& counter : r.counters) {
+                out << ", \"" << escape(counter.first) << "\": " << counter.second;
+            }
+            out << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+private:
+    static std::string escape(const std::string& s) {
+        std::string out;
+        for (char c : s) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        return out;
+    }
+
+    void print_row(const result& r) {
+        // При JSON в stdout таблица уходит в stderr, чтобы не портить вывод
+        std::ostream& out = options_.json_path == "-" ? std::cerr : std::cout;
+        if (!header_printed_) {
+            out << pad("benchmark", 56) << pad("median ns/op", 14) << pad("MAD", 10) << "reps\n";
+            header_printed_ = true;
+        }
+        char median_text[32], mad_text[32];
+        std::snprintf(median_text, sizeof(median_text), "%.2f", r.median_ns);
+        std::snprintf(mad_text, sizeof(mad_text), "%.2f", r.mad_ns);
+        out << pad(r.name, 56) << pad(median_text, 14) << pad(mad_text, 10) << r.repetitions;
+        for (const auto& counter : r.counters) {
+            char value_text[32];
+            std::snprintf(value_text, sizeof(value_text), "%.3g", counter.second);
+            out << "  " << counter.first << "=" << value_text;
+        }
+        out << "\n";
+    }
+
+    static std::string pad(const std::string& s, std::size_t width) {
+        return s.size() >= width ? s + " " : s + std::string(width - s.size(), ' ');
+    }
+
+    options options_;
+    std::unique_ptr<perf_counters> counters_;
+    std::vector<result> results_;
+    bool header_printed_ = false;
+};
+
+} // namespace bench
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef BIG_INTEGER_H
+#define BIG_INTEGER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Беззнаковое целое произвольной длины для нагрузочных тестов аллокатора.
+// Лимбы (32 бита, младший первым) лежат в std::vector с заданным
+// аллокатором: умножение на малое число растет на месте, произведение
+// двух чисел - новый вектор точного размера. Ноль - пустой вектор
+template <typename Alloc = std::allocator<std::uint32_t>>
+class big_uint {
+public:
+    using limb = std::uint32_t;
+    using allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<limb>;
+    using limb_vector = std::vector<limb, allocator_type>;
+
+    explicit big_uint(const allocator_type& alloc = allocator_type()) : limbs_(alloc) {}
+
+    big_uint(std::uint64_t value, const allocator_type& alloc) : limbs_(alloc) {
+        for (; value; value >>= 32) limbs_.push_back(static_cast<limb>(value));
+    }
+
+    allocator_type get_allocator() const { return limbs_.get_allocator(); }
+    const limb_vector& limbs() const noexcept { return limbs_; }
+    bool is_zero() const noexcept { return limbs_.empty(); }
+
+    std::size_t bit_length() const noexcept {
+        if (limbs_.empty()) return 0;
+        std::size_t bits = (limbs_.size() - 1) * 32;
+        for (limb top = limbs_.back(); top; top >>= 1) ++bits;
+        return bits;
+    }
+
+    // Умножение на месте; старший лимб добавляется в конец вектора
+    big_uint& operator*=(limb factor) {
+        if (factor == 0) {
+            limbs_.clear();
+            return *this;
+        }
+        std::uint64_t carry = 0;
+        for (limb& part : limbs_) {
+            std::uint64_t product = static_cast<std::uint64_t>(part) * factor + carry;
+            part = static_cast<limb>(product);
+            carry = product >> 32;
+        }
+        if (carry) limbs_.push_back(static_cast<limb>(carry));
+        return *this;
+    }
+
+    // Школьное умножение; результат получает аллокатор левого операнда
+    friend big_uint operator*(const big_uint& a, const big_uint& b) {
+        big_uint result(a.get_allocator());
+        if (a.is_zero() || b.is_zero()) return result;
+        result.limbs_.assign(a.limbs_.size() + b.limbs_.size(), 0);
+        for (std::size_t i = 0; i < a.limbs_.size(); ++i) {
+            std::uint64_t carry = 0;
+            std::uint64_t x = a.limbs_[i];
+            for (std::size_t j = 0; j < b.limbs_.size(); ++j) {
+                std::uint64_t t = x * b.limbs_[j] + result.limbs_[i + j] + carry;
+                result.limbs_[i + j] = static_cast<limb>(t);
+                carry = t >> 32;
+            }
+            result.limbs_[i + b.limbs_.size()] = static_cast<limb>(carry);
+        }
+        if (result.limbs_.back() == 0) result.limbs_.pop_back();
+        return result;
+    }
+
+    friend bool operator==(const big_uint& a, const big_uint& b) {
+        return std::equal(a.limbs_.begin(), a.limbs_.end(), b.limbs_.begin(), b.limbs_.end());
+    }
+
+    friend bool operator!=(const big_uint& a, const big_uint& b) { return !(a == b); }
+
+    // Десятичная запись; квадратичное время, для проверок и вывода
+    std::string to_string() const {
+        if (limbs_.empty()) return "0";
+        std::vector<limb> rest(limbs_.begin(), limbs_.end());
+        std::vector<limb> groups;  // По 9 десятичных цифр, младшие первыми
+        while (!rest.empty()) {
+            std::uint64_t remainder = 0;
+            for (std::size_t i = rest.size(); i-- > 0;) {
+                std::uint64_t current = (remainder << 32) | rest[i];
+                rest[i] = static_cast<limb>(current / 1000000000u);
+                remainder = current % 1000000000u;
+            }
+            groups.push_back(static_cast<limb>(remainder));
+            while (!rest.empty() && rest.back() == 0) rest.pop_back();
+        }
+        std::string out = std::to_string(groups.back());
+        for (std::size_t i = groups.size() - 1; i-- > 0;) {
+            std::string digits = std::to_string(groups[i]);
+            out.append(9 - digits.size(), '0');
+            out += digits;
+        }
+        return out;
+    }
+
+private:
+    limb_vector limbs_;
+};
+
+// Произведение lo * (lo + 1) * ... * hi деревом: соседние множители
+// перемножаются попарно, чтобы операнды умножения были близки по размеру.
+// Пустой диапазон (lo > hi) дает 1
+template <typename Alloc>
+big_uint<Alloc> range_product(std::uint32_t lo, std::uint32_t hi, const Alloc& alloc) {
+    using number = big_uint<Alloc>;
+    if (lo > hi) return number(1, alloc);
+    if (hi - lo < 16) {
+        number result(lo, alloc);
+        for (std::uint32_t k = lo + 1; k <= hi && k > lo; ++k) result *= k;
+        return result;
+    }
+    std::uint32_t mid = lo + (hi - lo) / 2;
+    return range_product(lo, mid, alloc) * range_product(mid + 1, hi, alloc);
+}
+
+#endif
@@ -0,0 +1,158 @@
+// Таблица факториалов на длинной арифметике: рост векторов лимбов
+// и произведения переменного размера на std::allocator и my_allocator.
+// Факториалы считаются подряд до --max; в std::map попадает каждый
+// --every-й (вся таблица до 100000! заняла бы около 10 ГиБ).
+// Использование: allocator_factorial [--max=N] [--every=N] [--reps=N] [--print]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "big_integer.h"
+#include "heap_counter.h"
+#include "my_allocator.h"
+
+HEAP_COUNTER_DEFINE_GLOBAL_NEW()
+
+namespace {
+
+struct factorial_options {
+    std::uint32_t max = 100000;
+    std::uint32_t every = 1000;
+    std::size_t repetitions = 3;
+    bool print = false;
+};
+
+template <typename Alloc>
+using factorial_table = std::map<std::uint32_t, big_uint<Alloc>, std::less<std::uint32_t>,
+    typename std::allocator_traits<Alloc>::template rebind_alloc<std::pair<const std::uint32_t, big_uint<Alloc>>>>;
+
+// Числа и узлы таблицы берут память из одного аллокатора (у my_allocator -
+// из одного семейства арен). Очередной отрезок множителей перемножается
+// деревом, затем текущий факториал умножается на него
+template <typename Alloc>
+factorial_table<Alloc> build_table(const factorial_options& opts) {
+    Alloc alloc;
+    factorial_table<Alloc> table(alloc);
+    big_uint<Alloc> current(1, alloc);
+    table.emplace(0, current);
+    for (std::uint32_t n = 0; n < opts.max;) {
+        std::uint32_t next = opts.max - n > opts.every ? n + opts.every : opts.max;
+        current = current * range_product(n + 1, next, alloc);
+        table.emplace(next, current);
+        n = next;
+    }
+    return table;
+}
+
+struct run_result {
+    double seconds = 0.0;
+    std::size_t peak_bytes = 0;  // Пик кучи сверх состояния до прогона
+};
+
+// Полный цикл: построение таблицы и ее разрушение
+template <typename Alloc>
+run_result measure(const factorial_options& opts) {
+    run_result best;
+    for (std::size_t rep = 0; rep < opts.repetitions; ++rep) {
+        std::size_t baseline = heap_counter::reset_peak();
+        auto start = std::chrono::steady_clock::now();
+        {
+            factorial_table<Alloc> table = build_table<Alloc>(opts);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (rep == 0 || seconds < best.seconds) best.seconds = seconds;
+        best.peak_bytes = heap_counter::peak() - baseline;
+    }
+    return best;
+}
+
+// Проверка: обе таблицы совпадают, а длина n! в битах равна
+// floor(log2(n!)) + 1 по lgamma (точности double с запасом хватает)
+template <typename A, typename B>
+bool verify(const factorial_table<A>& expected, const factorial_table<B>& actual) {
+    if (expected.size() != actual.size()) return false;
+    auto it = actual.begin();
+    for (const auto& entry : expected) {
+        if (entry.first != it->first) return false;
+        const auto& a = entry.second.limbs();
+        const auto& b = it->second.limbs();
+        if (!std::equal(a.begin(), a.end(), b.begin(), b.end())) return false;
+        double log2_value = std::lgamma(static_cast<double>(entry.first) + 1.0) / std::log(2.0);
+        if (entry.second.bit_length() != static_cast<std::size_t>(std::floor(log2_value)) + 1) return false;
+        ++it;
+    }
+    return true;
+}
+
+bool parse(int argc, char* argv[], factorial_options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value_of = [&](const char* prefix) -> const char* {
+            std::size_t len = std::string(prefix).size();
+            return arg.compare(0, len, prefix) == 0 ? arg.c_str() + len : nullptr;
+        };
+        if (const char* v = value_of("--max=")) opts.max = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10));
+        else if (const char* v = value_of("--every=")) opts.every = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10));
+        else if (const char* v = value_of("--reps=")) opts.repetitions = std::max<std::size_t>(1, std::strtoul(v, nullptr, 10));
+        else if (arg == "--print") opts.print = true;
+        else {
+            std::cerr << "Ошибка: неизвестный аргумент " << arg << "\n";
+            return false;
+        }
+    }
+    if (opts.every == 0) {
+        std::cerr << "Ошибка: --every должен быть больше 0\n";
+        return false;
+    }
+    return true;
+}
+
+template <typename T>
+using arena = my_allocator<T, 4096>;
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    factorial_options opts;
+    if (!parse(argc, argv, opts)) return 1;
+
+    // Самопроверка арифметики на известном значении
+    if (range_product(1, 25, arena<std::uint32_t>()).to_string() != "15511210043330985984000000") {
+        std::cerr << "Ошибка: неверное значение 25!\n";
+        return 1;
+    }
+
+    run_result with_std = measure<std::allocator<std::uint32_t>>(opts);
+    run_result with_arena = measure<arena<std::uint32_t>>(opts);
+
+    auto expected = build_table<std::allocator<std::uint32_t>>(opts);
+    auto actual = build_table<arena<std::uint32_t>>(opts);
+    bool ok = verify(expected, actual);
+
+    const auto& last = expected.rbegin()->second;
+    std::printf("%u! : %zu бит, %zu лимбов; в таблице %zu значений\n",
+                opts.max, last.bit_length(), last.limbs().size(), expected.size());
+    std::printf("%-20s %10s %14s\n", "backend", "seconds", "peak KiB");
+    std::printf("%-20s %10.3f %14zu\n", "std", with_std.seconds, with_std.peak_bytes / 1024);
+    std::printf("%-20s %10.3f %14zu\n", "my_allocator<4096>", with_arena.seconds, with_arena.peak_bytes / 1024);
+    std::printf("speedup %.2fx, memory %.2fx, check %s\n",
+                with_std.seconds / with_arena.seconds,
+                with_std.peak_bytes ? static_cast<double>(with_arena.peak_bytes) / static_cast<double>(with_std.peak_bytes) : 0.0,
+                ok ? "ok" : "FAIL");
+    if (opts.print) std::cout << opts.max << "! = " << last.to_string() << "\n";
+
+    if (!ok) {
+        std::cerr << "Ошибка: таблицы std и my_allocator расходятся\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+#ifndef HEAP_COUNTER_H
+#define HEAP_COUNTER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// Текущий и пиковый объем кучи программы: глобальный operator new
+// заменяется макросом HEAP_COUNTER_DEFINE_GLOBAL_NEW(), который ставится
+// ровно в один .cpp. Размер блока хранится в заголовке перед ним, поэтому
+// учитываются все аллокации, включая чанки my_allocator: формы с
+// std::align_val_t (чанки с выравниванием больше стандартного) тоже
+// заменяются
+namespace heap_counter {
+
+namespace detail {
+
+struct state {
+    std::atomic<std::size_t> current{0};
+    std::atomic<std::size_t> peak{0};
+};
+
+inline state counters;
+constexpr std::size_t header_size = alignof(std::max_align_t);
+
+inline void count(std::size_t size) noexcept {
+    auto& c = counters;
+    std::size_t now = c.current.fetch_add(size, std::memory_order_relaxed) + size;
+    std::size_t peak = c.peak.load(std::memory_order_relaxed);
+    while (now > peak && !c.peak.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+}
+
+} // namespace detail
+
+inline void* allocate(std::size_t size) {
+    auto* raw = static_cast<unsigned char*>(std::malloc(size + detail::header_size));
+    if (!raw) throw std::bad_alloc();
+    std::memcpy(raw, &size, sizeof(size));
+    detail::count(size);
+    return raw + detail::header_size;
+}
+
+inline void release(void* p) noexcept {
+    if (!p) return;
+    auto* raw = static_cast<unsigned char*>(p) - detail::header_size;
+    std::size_t size;
+    std::memcpy(&size, raw, sizeof(size));
+    detail::counters.current.fetch_sub(size, std::memory_order_relaxed);
+    std::free(raw);
+}
+
+// Выровненный блок: перед ним размер и указатель, полученный от malloc
+inline void* allocate(std::size_t size, std::align_val_t alignment) {
+    std::size_t align = static_cast<std::size_t>(alignment);
+    constexpr std::size_t header = sizeof(std::size_t) + sizeof(void*);
+    auto* raw = static_cast<unsigned char*>(std::malloc(size + header + align - 1));
+    if (!raw) throw std::bad_alloc();
+    auto address = (reinterpret_cast<std::uintptr_t>(raw) + header + align - 1) & ~(std::uintptr_t(align) - 1);
+    auto* p = reinterpret_cast<unsigned char*>(address);
+    std::memcpy(p - header, &size, sizeof(size));
+    std::memcpy(p - sizeof(void*), &raw, sizeof(void*));
+    detail::count(size);
+    return p;
+}
+
+inline void release(void* p, std::align_val_t) noexcept {
+    if (!p) return;
+    constexpr std::size_t header = sizeof(std::size_t) + sizeof(void*);
+    auto* block = static_cast<unsigned char*>(p);
+    std::size_t size;
+    void* raw;
+    std::memcpy(&size, block - header, sizeof(size));
+    std::memcpy(&raw, block - sizeof(void*), sizeof(void*));
+    detail::counters.current.fetch_sub(size, std::memory_order_relaxed);
+    std::free(raw);
+}
+
+inline std::size_t current() noexcept {
+    return detail::counters.current.load(std::memory_order_relaxed);
+}
+
+// Начало замера: пик сбрасывается к текущему объему, он же возвращается
+inline std::size_t reset_peak() noexcept {
+    std::size_t now = current();
+    detail::counters.peak.store(now, std::memory_order_relaxed);
+    return now;
+}
+
+inline std::size_t peak() noexcept {
+    return detail::counters.peak.load(std::memory_order_relaxed);
+}
+
+} // namespace heap_counter
+
+#define HEAP_COUNTER_DEFINE_GLOBAL_NEW()                                                          \
+    void* operator new(std::size_t size) { return heap_counter::allocate(size); }                 \
+    void* operator new[](std::size_t size) { return heap_counter::allocate(size); }               \
+    void operator delete(void* p) noexcept { heap_counter::release(p); }                          \
+    void operator delete[](void* p) noexcept { heap_counter::release(p); }                        \
+    void operator delete(void* p, std::size_t) noexcept { heap_counter::release(p); }             \
+    void operator delete[](void* p, std::size_t) noexcept { heap_counter::release(p); }           \
+    void* operator new(std::size_t size, std::align_val_t a) {                                    \
+        return heap_counter::allocate(size, a);                                                   \
+    }                                                                                             \
+    void* operator new[](std::size_t size, std::align_val_t a) {                                  \
+        return heap_counter::allocate(size, a);                                                   \
+    }                                                                                             \
+    void operator delete(void* p, std::align_val_t a) noexcept { heap_counter::release(p, a); }   \
+    void operator delete[](void* p, std::align_val_t a) noexcept { heap_counter::release(p, a); } \
+    void operator delete(void* p, std::size_t, std::align_val_t a) noexcept {                     \
+        heap_counter::release(p, a);                                                              \
+    }                                                                                             \
+    void operator delete[](void* p, std::size_t, std::align_val_t a) noexcept {                   \
+        heap_counter::release(p, a);                                                              \
+    }
+
+#endif
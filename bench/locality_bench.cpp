@@ -0,0 +1,181 @@
+// Локальность обхода узловых контейнеров после разной истории арены.
+// Использование: allocator_bench --locality [--n=N] [--warmup=N] [--reps=N]
+//                                [--filter=S] [--json[=path]] [--list] [--no-perf]
+//
+// Контейнер строится один раз, измеряется только полный обход; время и
+// счетчики perf (промахи L1d/LLC, если доступны) - на элемент.
+// Раскладки узлов (до построения контейнера через тот же аллокатор):
+// fresh      - ничего: узлы идут подряд в порядке обхода
+// interleave - выделено 2n узлов, освобожден каждый второй: узлы
+//              контейнера через один, обход по убыванию адресов
+// random     - выделено 2n узлов, освобождена случайная половина
+//              в случайном порядке, остальные живут до конца замера
+// shuffled   - выделено n узлов и все освобождены в случайном порядке:
+//              память та же, что у fresh, порядок обхода случайный
+// Каждая раскладка строится на my_allocator и на std::allocator. У std
+// итог зависит от malloc: glibc сливает соседние освобожденные блоки,
+// и shuffled у него выходит близким к fresh
+#include "locality_bench.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+#include "bench_harness.h"
+#include "my_allocator.h"
+#include "my_container.h"
+
+namespace {
+
+using value = std::uint64_t;
+
+enum class layout { fresh, interleave, random, shuffled };
+
+const char* layout_name(layout kind) {
+    switch (kind) {
+        case layout::fresh: return "fresh";
+        case layout::interleave: return "interleave";
+        case layout::random: return "random";
+        case layout::shuffled: return "shuffled";
+    }
+    return "";
+}
+
+// Вставка и обход для каждого вида контейнера
+template <typename Container>
+struct container_ops;
+
+template <typename Alloc>
+struct container_ops<my_container<value, Alloc>> {
+    static constexpr const char* name = "my_container";
+
+    static void insert(my_container<value, Alloc>& c, value v) { c.push_back(v); }
+
+    static value sum(const my_container<value, Alloc>& c) {
+        value total = 0;
+        for (value v : c) total += v;
+        return total;
+    }
+};
+
+template <typename Alloc>
+struct container_ops<std::map<value, value, std::less<value>, Alloc>> {
+    static constexpr const char* name = "map";
+
+    static void insert(std::map<value, value, std::less<value>, Alloc>& c, value v) { c.emplace(v, v); }
+
+    static value sum(const std::map<value, value, std::less<value>, Alloc>& c) {
+        value total = 0;
+        for (const auto& entry : c) total += entry.second;
+        return total;
+    }
+};
+
+// Контейнер и узлы-соседи, оставшиеся от подготовки раскладки.
+// Все объекты делят один аллокатор, поэтому узлы контейнера
+// занимают слоты, освобожденные соседями
+template <typename Container>
+struct arranged {
+    std::vector<Container> neighbours;  // По одному узлу в каждом
+    Container container;
+
+    template <typename Alloc>
+    explicit arranged(const Alloc& alloc) : container(alloc) {}
+};
+
+template <typename Container, typename Alloc>
+std::unique_ptr<arranged<Container>> arrange(layout kind, std::size_t n, std::uint64_t seed) {
+    using ops = container_ops<Container>;
+    Alloc alloc;
+    auto result = std::make_unique<arranged<Container>>(alloc);
+
+    if (kind != layout::fresh) {
+        std::size_t count = kind == layout::shuffled ? n : 2 * n;
+        result->neighbours.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            result->neighbours.emplace_back(alloc);
+            ops::insert(result->neighbours.back(), static_cast<value>(i));
+        }
+
+        // Порядок освобождения: последний освобожденный слот выдается первым
+        std::vector<std::size_t> order;
+        if (kind == layout::interleave) {
+            for (std::size_t i = 1; i < count; i += 2) order.push_back(i);
+        } else {
+            order.resize(count);
+            std::iota(order.begin(), order.end(), std::size_t(0));
+            std::shuffle(order.begin(), order.end(), std::mt19937_64(seed));
+            if (kind == layout::random) order.resize(n);
+        }
+        for (std::size_t i : order) result->neighbours[i].clear();
+    }
+
+    for (std::size_t i = 0; i < n; ++i) ops::insert(result->container, static_cast<value>(i));
+    return result;
+}
+
+template <typename Container, typename Alloc>
+void bench_layouts(bench::runner& runner, std::size_t n, const char* backend) {
+    using ops = container_ops<Container>;
+    const value expected = static_cast<value>(n) * static_cast<value>(n - 1) / 2;
+    for (layout kind : {layout::fresh, layout::interleave, layout::random, layout::shuffled}) {
+        std::string name = std::string("locality/") + ops::name + "/" + backend + "/" + layout_name(kind);
+        std::unique_ptr<arranged<Container>> data;
+        runner.run(name, n, [&](bench::timer& t) {
+            if (!data) {
+                // Подготовка один раз, при первом (прогревочном) вызове
+                t.pause();
+                data = arrange<Container, Alloc>(kind, n, 42);
+                t.resume();
+            }
+            value total = ops::sum(data->container);
+            bench::do_not_optimize(total);
+            if (total != expected) {
+                std::cerr << "Ошибка: " << name << ": сумма " << total << ", ожидалось " << expected << "\n";
+                std::exit(1);
+            }
+        });
+    }
+}
+
+template <template <typename> class Alloc>
+void bench_backend(bench::runner& runner, std::size_t n, const char* backend) {
+    bench_layouts<my_container<value, Alloc<value>>, Alloc<value>>(runner, n, backend);
+    using map_alloc = Alloc<std::pair<const value, value>>;
+    bench_layouts<std::map<value, value, std::less<value>, map_alloc>, map_alloc>(runner, n, backend);
+}
+
+template <typename T>
+using arena = my_allocator<T, 4096>;
+
+} // namespace
+
+int run_locality_bench(int argc, char* argv[]) {
+    bench::options options;
+    options.warmup = 1;
+    options.repetitions = 5;
+    std::size_t n = 1 << 20;  // Узлы заметно больше кэша последнего уровня
+    for (const auto& arg : options.parse(argc, argv)) {
+        if (arg.compare(0, 4, "--n=") == 0) {
+            n = std::max<std::size_t>(1, std::strtoul(arg.c_str() + 4, nullptr, 10));
+        } else {
+            std::cerr << "Ошибка: неизвестный аргумент " << arg << "\n";
+            return 1;
+        }
+    }
+    // Подготовка выполняется в прогревочном вызове
+    options.warmup = std::max<std::size_t>(1, options.warmup);
+
+    bench::runner runner(options);
+    bench_backend<arena>(runner, n, "my_allocator");
+    bench_backend<std::allocator>(runner, n, "std");
+    return runner.finish() ? 0 : 1;
+}
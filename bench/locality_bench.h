@@ -0,0 +1,9 @@
+#ifndef LOCALITY_BENCH_H
+#define LOCALITY_BENCH_H
+
+// Режим allocator_bench (--locality): скорость полного обхода
+// контейнера при разных раскладках узлов в памяти.
+// Аргументы - как у main, argv[0] пропускается
+int run_locality_bench(int argc, char* argv[]);
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+// Счетчики perf_event_open для бенчмарков. Каждое событие открывается
+// отдельно: недоступное (например, аппаратное в VM) просто пропускается.
+// Если не открылось ни одно аппаратное событие, используются программные.
+// Вне Linux набор счетчиков пуст
+namespace bench {
+
+class perf_counters {
+public:
+    perf_counters() {
+#if defined(__linux__)
+        open_event("cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        open_event("instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        open_event("l1d_misses", PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D));
+        open_event("llc_misses", PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_LL));
+        open_event("dtlb_misses", PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_DTLB));
+        open_event("branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        hardware_ = !events_.empty();
+        if (!hardware_) {
+            open_event("task_clock_ns", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK);
+            open_event("context_switches", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES);
+            open_event("cpu_migrations", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS);
+        }
+        open_event("page_faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS);
+#endif
+    }
+
+    ~perf_counters() {
+#if defined(__linux__)
+        for (auto& e : events_) close(e.fd);
+#endif
+    }
+
+    perf_counters(const perf_counters&) = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+
+    bool available() const noexcept { return !events_.empty(); }
+    bool hardware() const noexcept { return hardware_; }
+
+    // Обнуление накопленного
+    void reset() {
+        for (auto& e : events_) e.total = 0.0;
+    }
+
+    // Запуск и остановка могут чередоваться; значения накапливаются
+    void start() {
+#if defined(__linux__)
+        for (auto& e : events_) {
+            ioctl(e.fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(e.fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    void stop() {
+#if defined(__linux__)
+        for (auto& e : events_) ioctl(e.fd, PERF_EVENT_IOC_DISABLE, 0);
+        for (auto& e : events_) {
+            std::uint64_t data[3] = {0, 0, 0};  // value, time_enabled, time_running
+            if (read(e.fd, data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) continue;
+            // Поправка на мультиплексирование, если событие считалось не все время
+            double value = static_cast<double>(data[0]);
+            if (data[2] > 0 && data[2] < data[1]) {
+                value *= static_cast<double>(data[1]) / static_cast<double>(data[2]);
+            }
+            e.total += value;
+        }
+#endif
+    }
+
+    // Накопленные значения: имя события и сумма
+    std::vector<std::pair<std::string, double>> values() const {
+        std::vector<std::pair<std::string, double>> out;
+        for (const auto& e : events_) out.emplace_back(e.name, e.total);
+        return out;
+    }
+
+private:
+    struct event {
+        std::string name;
+        int fd;
+        double total;
+    };
+
+#if defined(__linux__)
+    static std::uint64_t cache_event(std::uint64_t cache) {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+
+    void open_event(const char* name, std::uint32_t type, std::uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (fd >= 0) events_.push_back({name, static_cast<int>(fd), 0.0});
+    }
+#endif
+
+    std::vector<event> events_;
+    bool hardware_ = false;
+};
+
+} // namespace bench
+
+#endif
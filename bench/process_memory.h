@@ -0,0 +1,69 @@
+#ifndef PROCESS_MEMORY_H
+#define PROCESS_MEMORY_H
+
+#include <cstddef>
+#include <cstdio>
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+// Память процесса по данным ОС. Вне Linux функции возвращают 0
+namespace process_memory {
+
+// Текущий RSS в байтах (/proc/self/statm)
+inline std::size_t current_rss() {
+#if defined(__linux__)
+    std::FILE* file = std::fopen("/proc/self/statm", "r");
+    if (!file) return 0;
+    unsigned long size = 0, resident = 0;
+    int read = std::fscanf(file, "%lu %lu", &size, &resident);
+    std::fclose(file);
+    if (read != 2) return 0;
+    return static_cast<std::size_t>(resident) * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#else
+    return 0;
+#endif
+}
+
+// Пиковый RSS процесса за все время работы (getrusage)
+inline std::size_t peak_rss() {
+#if defined(__linux__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024;  // ru_maxrss в КиБ
+#else
+    return 0;
+#endif
+}
+
+// Сводка /proc/self/smaps_rollup (ядро 4.14+), байты
+struct smaps_summary {
+    std::size_t rss = 0;
+    std::size_t pss = 0;
+    std::size_t anonymous = 0;
+    std::size_t private_dirty = 0;
+};
+
+inline smaps_summary smaps_rollup() {
+    smaps_summary result;
+#if defined(__linux__)
+    std::FILE* file = std::fopen("/proc/self/smaps_rollup", "r");
+    if (!file) return result;
+    char line[256];
+    while (std::fgets(line, sizeof(line), file)) {
+        unsigned long kib = 0;
+        if (std::sscanf(line, "Rss: %lu kB", &kib) == 1) result.rss = kib * 1024;
+        else if (std::sscanf(line, "Pss: %lu kB", &kib) == 1) result.pss = kib * 1024;
+        else if (std::sscanf(line, "Anonymous: %lu kB", &kib) == 1) result.anonymous = kib * 1024;
+        else if (std::sscanf(line, "Private_Dirty: %lu kB", &kib) == 1) result.private_dirty = kib * 1024;
+    }
+    std::fclose(file);
+#endif
+    return result;
+}
+
+} // namespace process_memory
+
+#endif
@@ -0,0 +1,393 @@
+// Масштабирование аллокатора по потокам.
+// Использование: allocator_bench --scaling [--mix=local|cross|shared]
+//     [--backend=std|my_allocator|all] [--threads=N] [--ops=N]
+//     [--batch=N] [--size=16|64|256] [--no-pin]
+//
+// local  - каждый поток выделяет и освобождает пачками через свой аллокатор
+// cross  - пары производитель/потребитель, освобождение в чужом потоке
+// shared - общий std::map под одним mutex
+#include "scaling_bench.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "bench_harness.h"
+#include "my_allocator.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+struct scaling_options {
+    std::string mix = "local";
+    std::string backend = "all";
+    std::size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t ops = 200000;   // Операций на поток
+    std::size_t batch = 64;     // Объектов в пачке для local
+    std::size_t size = 64;      // Размер объекта
+    bool pin = true;
+};
+
+// Латентность замеряется у каждой sample_period-й операции:
+// два вызова часов на каждую операцию исказили бы сам замер
+constexpr std::size_t sample_period = 16;
+
+// Закрепление потока за процессором index (по кругу среди доступных)
+void pin_to_cpu(std::size_t index) {
+#if defined(__linux__)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return;
+    std::vector<int> cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+    }
+    if (cpus.empty()) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpus[index % cpus.size()], &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)index;
+#endif
+}
+
+// Итог одного потока
+struct thread_report {
+    std::size_t operations = 0;
+    double seconds = 0.0;
+    std::vector<double> latency_ns;
+};
+
+// Общий старт: потоки ждут, пока все не будут готовы
+class start_gate {
+public:
+    explicit start_gate(std::size_t threads) : waiting_(threads) {}
+
+    void arrive_and_wait() {
+        waiting_.fetch_sub(1, std::memory_order_acq_rel);
+        while (waiting_.load(std::memory_order_acquire) != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    std::atomic<std::size_t> waiting_;
+};
+
+// Аллокатор с защитой для выделения/освобождения из разных потоков.
+// my_allocator не потокобезопасен, std::allocator - да
+template <typename Alloc>
+struct guarded_allocator {
+    Alloc alloc;
+    std::mutex mutex;
+    static constexpr bool needs_lock = !std::allocator_traits<Alloc>::is_always_equal::value;
+
+    typename Alloc::value_type* allocate() {
+        if constexpr (needs_lock) {
+            std::lock_guard<std::mutex> lock(mutex);
+            return alloc.allocate(1);
+        } else {
+            return alloc.allocate(1);
+        }
+    }
+
+    void deallocate(typename Alloc::value_type* p) {
+        if constexpr (needs_lock) {
+            std::lock_guard<std::mutex> lock(mutex);
+            alloc.deallocate(p, 1);
+        } else {
+            alloc.deallocate(p, 1);
+        }
+    }
+};
+
+// Однонаправленная очередь указателей производитель -> потребитель
+template <typename T>
+class spsc_queue {
+public:
+    bool push(T value) {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == capacity) return false;
+        items_[head % capacity] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& value) {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) return false;
+        value = items_[tail % capacity];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    static constexpr std::size_t capacity = 1024;
+    T items_[capacity];
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+};
+
+template <std::size_t Size>
+struct payload {
+    unsigned char bytes[Size];
+};
+
+// Поток local: свой аллокатор, пачки allocate, затем deallocate
+template <typename Alloc>
+thread_report run_local(const scaling_options& opts, start_gate& gate) {
+    thread_report report;
+    report.latency_ns.reserve(opts.ops / sample_period + 1);
+    Alloc alloc;
+    std::vector<typename Alloc::value_type*> batch(opts.batch);
+    gate.arrive_and_wait();
+
+    auto start = clock_type::now();
+    while (report.operations < opts.ops) {
+        for (auto& p : batch) {
+            if (report.operations++ % sample_period == 0) {
+                auto t0 = clock_type::now();
+                p = alloc.allocate(1);
+                report.latency_ns.push_back(std::chrono::duration<double, std::nano>(clock_type::now() - t0).count());
+            } else {
+                p = alloc.allocate(1);
+            }
+        }
+        bench::clobber_memory();
+        for (auto p : batch) alloc.deallocate(p, 1);
+    }
+    report.seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+    return report;
+}
+
+template <typename Alloc>
+using value_of = typename Alloc::value_type;
+
+// Производитель: выделяет и передает потребителю
+template <typename Alloc>
+thread_report run_producer(const scaling_options& opts, start_gate& gate,
+                           guarded_allocator<Alloc>& arena, spsc_queue<value_of<Alloc>*>& queue) {
+    thread_report report;
+    report.latency_ns.reserve(opts.ops / sample_period + 1);
+    gate.arrive_and_wait();
+
+    auto start = clock_type::now();
+    for (std::size_t i = 0; i < opts.ops; ++i) {
+        value_of<Alloc>* p;
+        if (i % sample_period == 0) {
+            auto t0 = clock_type::now();
+            p = arena.allocate();
+            report.latency_ns.push_back(std::chrono::duration<double, std::nano>(clock_type::now() - t0).count());
+        } else {
+            p = arena.allocate();
+        }
+        while (!queue.push(p)) std::this_thread::yield();
+    }
+    report.operations = opts.ops;
+    report.seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+    return report;
+}
+
+// Потребитель: освобождает чужие блоки
+template <typename Alloc>
+thread_report run_consumer(const scaling_options& opts, start_gate& gate,
+                           guarded_allocator<Alloc>& arena, spsc_queue<value_of<Alloc>*>& queue) {
+    thread_report report;
+    report.latency_ns.reserve(opts.ops / sample_period + 1);
+    gate.arrive_and_wait();
+
+    auto start = clock_type::now();
+    for (std::size_t i = 0; i < opts.ops; ++i) {
+        value_of<Alloc>* p;
+        while (!queue.pop(p)) std::this_thread::yield();
+        if (i % sample_period == 0) {
+            auto t0 = clock_type::now();
+            arena.deallocate(p);
+            report.latency_ns.push_back(std::chrono::duration<double, std::nano>(clock_type::now() - t0).count());
+        } else {
+            arena.deallocate(p);
+        }
+    }
+    report.operations = opts.ops;
+    report.seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+    return report;
+}
+
+// Общий map: вставка случайного ключа, при переполнении удаление наименьшего
+template <typename Map>
+thread_report run_shared(const scaling_options& opts, start_gate& gate,
+                         Map& map, std::mutex& mutex, std::size_t seed) {
+    thread_report report;
+    report.latency_ns.reserve(opts.ops / sample_period + 1);
+    std::mt19937 rng(static_cast<std::mt19937::result_type>(seed));
+    const std::size_t limit = 4096;
+    gate.arrive_and_wait();
+
+    auto start = clock_type::now();
+    for (std::size_t i = 0; i < opts.ops; ++i) {
+        int key = static_cast<int>(rng());
+        auto t0 = clock_type::now();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            map.emplace(key, key);
+            if (map.size() > limit) map.erase(map.begin());
+        }
+        if (i % sample_period == 0) {
+            report.latency_ns.push_back(std::chrono::duration<double, std::nano>(clock_type::now() - t0).count());
+        }
+    }
+    report.operations = opts.ops;
+    report.seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+    return report;
+}
+
+// Запуск threads потоков с нужной ролью
+template <typename Alloc>
+std::vector<thread_report> run_threads(const scaling_options& opts, std::size_t threads) {
+    std::vector<thread_report> reports(threads);
+    std::vector<std::thread> workers;
+    start_gate gate(threads);
+
+    auto spawn = [&](std::size_t index, auto&& body) {
+        workers.emplace_back([&, index, body]() mutable {
+            if (opts.pin) pin_to_cpu(index);
+            reports[index] = body();
+        });
+    };
+
+    if (opts.mix == "local") {
+        for (std::size_t i = 0; i < threads; ++i) {
+            spawn(i, [&] { return run_local<Alloc>(opts, gate); });
+        }
+        for (auto& w : workers) w.join();
+    } else if (opts.mix == "cross") {
+        std::size_t pairs = threads / 2;
+        std::vector<std::unique_ptr<guarded_allocator<Alloc>>> arenas;
+        std::vector<std::unique_ptr<spsc_queue<value_of<Alloc>*>>> queues;
+        for (std::size_t p = 0; p < pairs; ++p) {
+            arenas.push_back(std::make_unique<guarded_allocator<Alloc>>());
+            queues.push_back(std::make_unique<spsc_queue<value_of<Alloc>*>>());
+        }
+        for (std::size_t p = 0; p < pairs; ++p) {
+            auto& arena = *arenas[p];
+            auto& queue = *queues[p];
+            spawn(2 * p, [&] { return run_producer<Alloc>(opts, gate, arena, queue); });
+            spawn(2 * p + 1, [&] { return run_consumer<Alloc>(opts, gate, arena, queue); });
+        }
+        for (auto& w : workers) w.join();
+    } else {
+        using map_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<std::pair<const int, int>>;
+        std::map<int, int, std::less<int>, map_alloc> map;
+        std::mutex mutex;
+        for (std::size_t i = 0; i < threads; ++i) {
+            spawn(i, [&, i] { return run_shared(opts, gate, map, mutex, i + 1); });
+        }
+        for (auto& w : workers) w.join();
+    }
+    return reports;
+}
+
+double percentile(std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    std::size_t index = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+template <typename Alloc>
+void run_backend(const scaling_options& opts, const char* name) {
+    // Степени двойки до max_threads и сам max_threads; в cross - только четные
+    std::size_t first = opts.mix == "cross" ? 2 : 1;
+    std::size_t last = opts.mix == "cross" ? opts.max_threads & ~std::size_t(1) : opts.max_threads;
+    last = std::max(first, last);
+    std::vector<std::size_t> counts;
+    for (std::size_t n = first; n < last; n *= 2) counts.push_back(n);
+    counts.push_back(last);
+
+    double baseline_per_thread = 0.0;
+    for (std::size_t threads : counts) {
+        auto reports = run_threads<Alloc>(opts, threads);
+        std::size_t operations = 0;
+        double seconds = 0.0;
+        std::vector<double> latency;
+        for (auto& r : reports) {
+            operations += r.operations;
+            seconds = std::max(seconds, r.seconds);
+            latency.insert(latency.end(), r.latency_ns.begin(), r.latency_ns.end());
+        }
+        std::sort(latency.begin(), latency.end());
+        double total = seconds > 0 ? operations / seconds : 0.0;
+        double per_thread = total / threads;
+        if (baseline_per_thread == 0.0) baseline_per_thread = per_thread;
+        std::printf("%-20s %-7s %7zu %14.0f %14.0f %10.2f %10.0f %10.0f %10.0f\n",
+                    name, opts.mix.c_str(), threads, total, per_thread,
+                    baseline_per_thread > 0 ? per_thread / baseline_per_thread : 0.0,
+                    percentile(latency, 0.5), percentile(latency, 0.99), percentile(latency, 0.999));
+    }
+}
+
+template <std::size_t Size>
+void run_size(const scaling_options& opts) {
+    using T = payload<Size>;
+    if (opts.backend == "all" || opts.backend == "std") {
+        run_backend<std::allocator<T>>(opts, "std");
+    }
+    if (opts.backend == "all" || opts.backend == "my_allocator") {
+        run_backend<my_allocator<T, 4096>>(opts, "my_allocator<4096>");
+    }
+}
+
+} // namespace
+
+int run_scaling_bench(const std::vector<std::string>& args) {
+    scaling_options opts;
+    for (const auto& arg : args) {
+        auto value = [&](const char* prefix) -> const char* {
+            std::size_t len = std::string(prefix).size();
+            return arg.compare(0, len, prefix) == 0 ? arg.c_str() + len : nullptr;
+        };
+        if (const char* v = value("--mix=")) opts.mix = v;
+        else if (const char* v = value("--backend=")) opts.backend = v;
+        else if (const char* v = value("--threads=")) opts.max_threads = std::max<std::size_t>(1, std::strtoul(v, nullptr, 10));
+        else if (const char* v = value("--ops=")) opts.ops = std::max<std::size_t>(1, std::strtoul(v, nullptr, 10));
+        else if (const char* v = value("--batch=")) opts.batch = std::max<std::size_t>(1, std::strtoul(v, nullptr, 10));
+        else if (const char* v = value("--size=")) opts.size = std::strtoul(v, nullptr, 10);
+        else if (arg == "--no-pin") opts.pin = false;
+        else {
+            std::cerr << "Ошибка: неизвестный аргумент " << arg << "\n";
+            return 1;
+        }
+    }
+    if (opts.mix != "local" && opts.mix != "cross" && opts.mix != "shared") {
+        std::cerr << "Ошибка: неизвестный режим " << opts.mix << "\n";
+        return 1;
+    }
+
+    std::printf("%-20s %-7s %7s %14s %14s %10s %10s %10s %10s\n",
+                "backend", "mix", "threads", "ops/s", "ops/s/thread", "efficiency",
+                "p50_ns", "p99_ns", "p99.9_ns");
+    switch (opts.size) {
+        case 16: run_size<16>(opts); break;
+        case 64: run_size<64>(opts); break;
+        case 256: run_size<256>(opts); break;
+        default:
+            std::cerr << "Ошибка: поддерживаются размеры 16, 64, 256\n";
+            return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,11 @@
+#ifndef SCALING_BENCH_H
+#define SCALING_BENCH_H
+
+#include <string>
+#include <vector>
+
+// Многопоточный режим allocator_bench (--scaling): масштабирование
+// аллокатора от 1 потока до числа ядер
+int run_scaling_bench(const std::vector<std::string>& args);
+
+#endif
@@ -0,0 +1,164 @@
+// Длительный прогон с перемешанными вставками/удалениями для поиска
+// роста фрагментации. Пишет CSV с RSS и живыми байтами аллокатора;
+// без MY_ALLOCATOR_STATS столбцы аллокатора остаются пустыми.
+// Использование: allocator_soak [--duration=SEC] [--interval=MS]
+//                               [--keys=N] [--seed=N] [--csv=path]
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "my_allocator.h"
+#include "my_container.h"
+#include "process_memory.h"
+
+namespace {
+
+struct soak_options {
+    double duration = 3600.0;        // Секунды
+    unsigned interval_ms = 1000;     // Период снятия отсчетов
+    std::size_t keys = 1000000;      // Пространство ключей map
+    std::size_t containers = 256;    // Количество my_container
+    std::uint32_t seed = 1;
+    std::string csv_path;            // Пусто - stdout
+};
+
+// Значение map с размером типичной записи
+struct record_value {
+    std::uint64_t fields[6];
+};
+
+using map_allocator = my_allocator<std::pair<const int, record_value>, 4096>;
+using soak_map = std::map<int, record_value, std::less<int>, map_allocator>;
+using soak_container = my_container<std::uint64_t, my_allocator<std::uint64_t, 4096>>;
+
+bool parse(int argc, char* argv[], soak_options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](const char* prefix) -> const char* {
+            std::size_t len = std::string(prefix).size();
+            return arg.compare(0, len, prefix) == 0 ? arg.c_str() + len : nullptr;
+        };
+        if (const char* v = value("--duration=")) opts.duration = std::strtod(v, nullptr);
+        else if (const char* v = value("--interval=")) opts.interval_ms = static_cast<unsigned>(std::strtoul(v, nullptr, 10));
+        else if (const char* v = value("--keys=")) opts.keys = std::strtoul(v, nullptr, 10);
+        else if (const char* v = value("--seed=")) opts.seed = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10));
+        else if (const char* v = value("--csv=")) opts.csv_path = v;
+        else {
+            std::cerr << "Ошибка: неизвестный аргумент " << arg << "\n";
+            return false;
+        }
+    }
+    if (opts.keys == 0 || opts.interval_ms == 0) {
+        std::cerr << "Ошибка: --keys и --interval должны быть больше нуля\n";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    soak_options opts;
+    if (!parse(argc, argv, opts)) return 1;
+
+#if MY_ALLOCATOR_SNAPSHOT
+    // kill -USR2 <pid> пишет снимок арен в ALLOCATOR_LAB_SNAPSHOT_DIR (по умолчанию - текущий каталог)
+    const char* snapshot_dir = std::getenv("ALLOCATOR_LAB_SNAPSHOT_DIR");
+    if (!heap_snapshot::install_signal_handler(snapshot_dir ? snapshot_dir : ".")) {
+        std::cerr << "Предупреждение: снимок кучи по сигналу недоступен\n";
+    }
+#endif
+#if !MY_ALLOCATOR_STATS
+    std::cerr << "Предупреждение: сборка без MY_ALLOCATOR_STATS, столбцы allocator_live, "
+                 "allocator_reserved и rss_live_ratio пусты\n";
+#endif
+
+    std::FILE* out = stdout;
+    if (!opts.csv_path.empty()) {
+        out = std::fopen(opts.csv_path.c_str(), "w");
+        if (!out) {
+            std::cerr << "Ошибка: не удалось открыть " << opts.csv_path << "\n";
+            return 1;
+        }
+    }
+
+    std::fprintf(out, "elapsed_s,operations,map_size,container_elements,"
+                      "statm_rss,smaps_rss,smaps_anon,smaps_private_dirty,"
+                      "allocator_live,allocator_reserved,rss_live_ratio\n");
+
+    std::mt19937 rng(opts.seed);
+    std::uniform_int_distribution<int> key_dist(0, static_cast<int>(opts.keys - 1));
+    std::uniform_int_distribution<std::size_t> container_dist(0, opts.containers - 1);
+    std::uniform_int_distribution<int> action_dist(0, 99);
+
+    soak_map map;
+    std::vector<soak_container> containers(opts.containers);
+    std::size_t container_elements = 0;
+    std::uint64_t operations = 0;
+
+    auto sample = [&](double elapsed) {
+        auto smaps = process_memory::smaps_rollup();
+        std::size_t rss = process_memory::current_rss();
+        std::fprintf(out, "%.1f,%llu,%zu,%zu,%zu,%zu,%zu,%zu,",
+                     elapsed, static_cast<unsigned long long>(operations), map.size(), container_elements,
+                     rss, smaps.rss, smaps.anonymous, smaps.private_dirty);
+#if MY_ALLOCATOR_STATS
+        // map прячет свой экземпляр аллокатора, поэтому суммарная статистика
+        auto stats = allocator_global_stats();
+        std::uint64_t live = stats.live_bytes();
+        std::uint64_t reserved = stats.reserved_bytes();
+        std::fprintf(out, "%llu,%llu,%.4f\n",
+                     static_cast<unsigned long long>(live), static_cast<unsigned long long>(reserved),
+                     live ? static_cast<double>(rss) / static_cast<double>(live) : 0.0);
+#else
+        std::fprintf(out, ",,\n");
+#endif
+        std::fflush(out);
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    const auto interval = std::chrono::milliseconds(opts.interval_ms);
+    auto next_sample = start + interval;
+    sample(0.0);
+
+    for (;;) {
+        // Часы проверяются раз в пачку операций
+        for (int i = 0; i < 4096; ++i, ++operations) {
+            int action = action_dist(rng);
+            if (action < 45) {
+                int key = key_dist(rng);
+                map.emplace(key, record_value{{static_cast<std::uint64_t>(key)}});
+            } else if (action < 90) {
+                map.erase(key_dist(rng));
+            } else if (action < 99) {
+                // Дозапись в случайный контейнер
+                auto& container = containers[container_dist(rng)];
+                std::size_t count = 1 + static_cast<std::size_t>(action_dist(rng));
+                for (std::size_t j = 0; j < count; ++j) container.push_back(operations);
+                container_elements += count;
+            } else {
+                auto& container = containers[container_dist(rng)];
+                container_elements -= container.size();
+                container.clear();
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - start).count();
+        if (now >= next_sample) {
+            sample(elapsed);
+            next_sample += interval;
+        }
+        if (elapsed >= opts.duration) break;
+    }
+
+    if (out != stdout) std::fclose(out);
+    return 0;
+}
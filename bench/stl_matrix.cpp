@@ -0,0 +1,247 @@
+// Совместимость и производительность my_allocator со стандартными
+// контейнерами: для каждого контейнера и размера - заполнение, проверка
+// содержимого и разрушение на std::allocator и на my_allocator.
+// Пик памяти считается заменой глобального operator new (heap_counter.h).
+// Использование: allocator_stl_matrix [--min=N] [--max=N] [--filter=S] [--seed=N]
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <forward_list>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <map>
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "heap_counter.h"
+#include "my_allocator.h"
+
+HEAP_COUNTER_DEFINE_GLOBAL_NEW()
+
+namespace {
+
+using value = std::uint64_t;
+
+template <typename T>
+using arena = my_allocator<T, 4096>;
+
+// Сумма 0..n-1 - ожидаемая контрольная сумма большинства нагрузок
+value series(std::size_t n) {
+    return static_cast<value>(n) * static_cast<value>(n ? n - 1 : 0) / 2;
+}
+
+// Нагрузки: каждая повторяет типичный для контейнера порядок аллокаций
+// и возвращает контрольную сумму, посчитанную через контейнер
+template <template <typename> class Alloc>
+struct workloads {
+    static value vector(const std::vector<value>&, std::size_t n) {
+        std::vector<value, Alloc<value>> c;
+        for (std::size_t i = 0; i < n; ++i) c.push_back(i);  // Рост с перевыделением
+        return std::accumulate(c.begin(), c.end(), value(0));
+    }
+
+    static value deque(const std::vector<value>&, std::size_t n) {
+        std::deque<value, Alloc<value>> c;
+        for (std::size_t i = 0; i < n; ++i) c.push_back(i);
+        for (std::size_t i = 0; i < n / 2; ++i) c.pop_front();  // Освобождение блоков с головы
+        return std::accumulate(c.begin(), c.end(), value(0));
+    }
+
+    static value list(const std::vector<value>&, std::size_t n) {
+        std::list<value, Alloc<value>> c;
+        for (std::size_t i = 0; i < n; ++i) c.push_back(i);
+        c.remove_if([](value v) { return v % 2; });  // Освобождение через один
+        for (std::size_t i = 1; i < n; i += 2) c.push_back(i);  // Повторное использование слотов
+        return std::accumulate(c.begin(), c.end(), value(0));
+    }
+
+    static value forward_list(const std::vector<value>&, std::size_t n) {
+        std::forward_list<value, Alloc<value>> c;
+        for (std::size_t i = 0; i < n; ++i) c.push_front(i);
+        return std::accumulate(c.begin(), c.end(), value(0));
+    }
+
+    static value set(const std::vector<value>& keys, std::size_t n) {
+        std::set<value, std::less<value>, Alloc<value>> c;
+        for (std::size_t i = 0; i < n; ++i) c.insert(keys[i]);
+        value sum = 0;
+        for (std::size_t i = 0; i < n; ++i) sum += *c.find(i);
+        return sum;
+    }
+
+    static value map(const std::vector<value>& keys, std::size_t n) {
+        std::map<value, value, std::less<value>, Alloc<std::pair<const value, value>>> c;
+        for (std::size_t i = 0; i < n; ++i) c.emplace(keys[i], keys[i]);
+        value sum = 0;
+        for (std::size_t i = 0; i < n; ++i) sum += c.find(i)->second;
+        return sum;
+    }
+
+    static value multimap(const std::vector<value>& keys, std::size_t n) {
+        std::multimap<value, value, std::less<value>, Alloc<std::pair<const value, value>>> c;
+        value buckets = static_cast<value>(n / 4 + 1);  // Повторяющиеся ключи
+        for (std::size_t i = 0; i < n; ++i) c.emplace(keys[i] % buckets, keys[i]);
+        value sum = 0;
+        for (value k = 0; k < buckets; ++k) {
+            auto range = c.equal_range(k);
+            for (auto it = range.first; it != range.second; ++it) sum += it->second;
+        }
+        return sum;
+    }
+
+    static value unordered_map(const std::vector<value>& keys, std::size_t n) {
+        std::unordered_map<value, value, std::hash<value>, std::equal_to<value>,
+                           Alloc<std::pair<const value, value>>> c;
+        for (std::size_t i = 0; i < n; ++i) c.emplace(keys[i], keys[i]);  // Рост с перехешированием
+        value sum = 0;
+        for (std::size_t i = 0; i < n; ++i) sum += c.find(i)->second;
+        return sum;
+    }
+
+    static value unordered_set(const std::vector<value>& keys, std::size_t n) {
+        std::unordered_set<value, std::hash<value>, std::equal_to<value>, Alloc<value>> c;
+        for (std::size_t i = 0; i < n; ++i) c.insert(keys[i]);
+        value sum = 0;
+        for (std::size_t i = 0; i < n; ++i) sum += *c.find(i);
+        return sum;
+    }
+
+    static value basic_string(const std::vector<value>&, std::size_t n) {
+        std::basic_string<char, std::char_traits<char>, Alloc<char>> c;
+        for (std::size_t i = 0; i < n; ++i) c.push_back(static_cast<char>('a' + i % 26));
+        value sum = 0;
+        for (char ch : c) sum += static_cast<unsigned char>(ch);
+        return sum;
+    }
+};
+
+value string_checksum(std::size_t n) {
+    value sum = 0;
+    for (std::size_t i = 0; i < n; ++i) sum += static_cast<value>('a' + i % 26);
+    return sum;
+}
+
+using workload = value (*)(const std::vector<value>&, std::size_t);
+
+struct container_case {
+    const char* name;
+    workload with_std;
+    workload with_arena;
+    value (*expected)(std::size_t);
+};
+
+#define CONTAINER_CASE(name, expected) \
+    {#name, &workloads<std::allocator>::name, &workloads<arena>::name, expected}
+
+const container_case cases[] = {
+    CONTAINER_CASE(vector, series),
+    CONTAINER_CASE(deque, [](std::size_t n) { return series(n) - series(n / 2); }),
+    CONTAINER_CASE(list, series),
+    CONTAINER_CASE(forward_list, series),
+    CONTAINER_CASE(set, series),
+    CONTAINER_CASE(map, series),
+    CONTAINER_CASE(multimap, series),
+    CONTAINER_CASE(unordered_map, series),
+    CONTAINER_CASE(unordered_set, series),
+    CONTAINER_CASE(basic_string, string_checksum),
+};
+
+#undef CONTAINER_CASE
+
+struct run_result {
+    double seconds = 0.0;
+    std::size_t peak_bytes = 0;  // Пик кучи сверх состояния до прогона
+    value checksum = 0;
+};
+
+run_result measure(workload body, const std::vector<value>& keys, std::size_t n) {
+    run_result result;
+    std::size_t baseline = heap_counter::reset_peak();
+    auto start = std::chrono::steady_clock::now();
+    result.checksum = body(keys, n);
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.peak_bytes = heap_counter::peak() - baseline;
+    return result;
+}
+
+struct matrix_options {
+    std::size_t min = 1000;
+    std::size_t max = 10000000;
+    std::string filter;
+    std::uint32_t seed = 1;
+};
+
+bool parse(int argc, char* argv[], matrix_options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value_of = [&](const char* prefix) -> const char* {
+            std::size_t len = std::string(prefix).size();
+            return arg.compare(0, len, prefix) == 0 ? arg.c_str() + len : nullptr;
+        };
+        if (const char* v = value_of("--min=")) opts.min = std::strtoul(v, nullptr, 10);
+        else if (const char* v = value_of("--max=")) opts.max = std::strtoul(v, nullptr, 10);
+        else if (const char* v = value_of("--filter=")) opts.filter = v;
+        else if (const char* v = value_of("--seed=")) opts.seed = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10));
+        else {
+            std::cerr << "Ошибка: неизвестный аргумент " << arg << "\n";
+            return false;
+        }
+    }
+    if (opts.min == 0 || opts.max < opts.min) {
+        std::cerr << "Ошибка: нужно 0 < --min <= --max\n";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    matrix_options opts;
+    if (!parse(argc, argv, opts)) return 1;
+
+    std::printf("%-14s %10s %12s %12s %8s %12s %12s %8s  %s\n",
+                "container", "n", "std Mops/s", "my Mops/s", "speedup",
+                "std peak KiB", "my peak KiB", "memory", "check");
+    int failures = 0;
+    for (std::size_t n = opts.min; n <= opts.max; n *= 10) {
+        // Ключи в случайном порядке, общие для обоих аллокаторов
+        std::vector<value> keys(n);
+        std::iota(keys.begin(), keys.end(), value(0));
+        std::shuffle(keys.begin(), keys.end(), std::mt19937_64(opts.seed));
+
+        for (const container_case& c : cases) {
+            if (!opts.filter.empty() && std::string(c.name).find(opts.filter) == std::string::npos) continue;
+            run_result with_std = measure(c.with_std, keys, n);
+            run_result with_arena = measure(c.with_arena, keys, n);
+            value expected = c.expected(n);
+            bool ok = with_std.checksum == expected && with_arena.checksum == expected;
+            failures += !ok;
+
+            double ops = static_cast<double>(n) / 1e6;
+            std::printf("%-14s %10zu %12.2f %12.2f %7.2fx %12zu %12zu %7.2fx  %s\n",
+                        c.name, n, ops / with_std.seconds, ops / with_arena.seconds,
+                        with_std.seconds / with_arena.seconds,
+                        with_std.peak_bytes / 1024, with_arena.peak_bytes / 1024,
+                        with_std.peak_bytes ? static_cast<double>(with_arena.peak_bytes) / static_cast<double>(with_std.peak_bytes) : 0.0,
+                        ok ? "ok" : "FAIL");
+            std::fflush(stdout);
+        }
+        if (n > opts.max / 10) break;  // Без переполнения n *= 10
+    }
+
+    if (failures) {
+        std::cerr << "Ошибка: расхождение контрольных сумм в " << failures << " случаях\n";
+        return 1;
+    }
+    return 0;
+}
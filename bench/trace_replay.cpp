@@ -0,0 +1,266 @@
+// Воспроизведение трассы allocation_trace на разных аллокаторах.
+// Использование: allocator_replay <trace.bin> [backend ...]
+//                allocator_replay --workload=SPEC [backend ...]
+// SPEC - синтетический поток, см. workload_generator.h
+// backend: std, my_allocator:64, my_allocator:1024, my_allocator:16384,
+//          pmr-pool, pmr-monotonic (по умолчанию - все)
+// Каждый backend прогоняется в отдельном дочернем процессе
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "allocation_trace.h"
+#include "my_allocator.h"
+#include "process_memory.h"
+#include "workload_generator.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define ALLOCATOR_REPLAY_FORK 1
+#else
+#define ALLOCATOR_REPLAY_FORK 0
+#endif
+
+namespace {
+
+// Результат прогона трассы на одном аллокаторе
+struct replay_result {
+    double seconds = 0.0;
+    std::size_t operations = 0;
+    std::size_t unmatched_frees = 0;   // deallocate без парного allocate в трассе
+    std::size_t peak_live_bytes = 0;   // Пик живых байт по трассе
+    std::size_t peak_rss_growth = 0;   // Пик RSS относительно начала прогона
+};
+
+// Ячейка для my_allocator: выравнивание как у malloc
+struct alignas(alignof(std::max_align_t)) slot {
+    unsigned char bytes[alignof(std::max_align_t)];
+};
+
+constexpr std::size_t slots_for(std::size_t bytes) {
+    return (bytes + sizeof(slot) - 1) / sizeof(slot);
+}
+
+struct std_backend {
+    std::allocator<slot> alloc;
+
+    void* allocate(std::size_t bytes) { return alloc.allocate(slots_for(bytes)); }
+    void deallocate(void* p, std::size_t bytes) {
+        alloc.deallocate(static_cast<slot*>(p), slots_for(bytes));
+    }
+};
+
+template <std::size_t ChunkSize>
+struct arena_backend {
+    my_allocator<slot, ChunkSize> alloc;
+
+    void* allocate(std::size_t bytes) { return alloc.allocate(slots_for(bytes)); }
+    void deallocate(void* p, std::size_t bytes) {
+        alloc.deallocate(static_cast<slot*>(p), slots_for(bytes));
+    }
+};
+
+template <typename Resource>
+struct pmr_backend {
+    Resource resource;
+
+    void* allocate(std::size_t bytes) {
+        return resource.allocate(bytes ? bytes : 1, alignof(std::max_align_t));
+    }
+    void deallocate(void* p, std::size_t bytes) {
+        resource.deallocate(p, bytes ? bytes : 1, alignof(std::max_align_t));
+    }
+};
+
+// Однопоточный прогон в порядке временных меток. Адреса из трассы
+// служат только идентификаторами блоков
+template <typename Backend>
+replay_result replay(const std::vector<allocation_trace::record>& trace) {
+    replay_result result;
+    std::unordered_map<std::uint64_t, std::pair<void*, std::size_t>> live;
+    live.reserve(trace.size());
+    // Таблица заполняется заранее, чтобы ее страницы не попали в рост RSS
+    for (const auto& rec : trace) {
+        live.emplace(rec.address, std::pair<void*, std::size_t>(nullptr, 0));
+    }
+
+    std::size_t rss_base = process_memory::current_rss();
+    std::size_t live_bytes = 0;
+    // Чтение /proc/self/statm - системный вызов; его время вычитается
+    // из времени прогона, чтобы не попасть в Mops/s
+    std::chrono::steady_clock::duration sampling{};
+    auto sample_rss = [&] {
+        auto sample_start = std::chrono::steady_clock::now();
+        std::size_t rss = process_memory::current_rss();
+        if (rss > rss_base && rss - rss_base > result.peak_rss_growth) {
+            result.peak_rss_growth = rss - rss_base;
+        }
+        sampling += std::chrono::steady_clock::now() - sample_start;
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        Backend backend;
+        for (const auto& rec : trace) {
+            if (rec.kind == static_cast<std::uint8_t>(allocation_trace::op::allocate)) {
+                void* p = backend.allocate(rec.size);
+                auto& entry = live[rec.address];
+                if (entry.first) {
+                    // Пропущенный в трассе deallocate - освобождаем старый блок
+                    backend.deallocate(entry.first, entry.second);
+                    live_bytes -= entry.second;
+                }
+                entry = {p, rec.size};
+                live_bytes += rec.size;
+                if (live_bytes > result.peak_live_bytes) result.peak_live_bytes = live_bytes;
+            } else {
+                auto it = live.find(rec.address);
+                if (it == live.end() || !it->second.first) {
+                    ++result.unmatched_frees;
+                    continue;
+                }
+                backend.deallocate(it->second.first, it->second.second);
+                live_bytes -= it->second.second;
+                it->second.first = nullptr;
+            }
+            if ((++result.operations & 4095) == 0) sample_rss();
+        }
+        sample_rss();
+
+        // Оставшиеся блоки освобождаются, как это сделал бы процесс при выходе
+        for (auto& entry : live) {
+            if (entry.second.first) backend.deallocate(entry.second.first, entry.second.second);
+        }
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start - sampling).count();
+    return result;
+}
+
+void print(const std::string& name, const replay_result& r) {
+    double fragmentation = 0.0;
+    if (r.peak_rss_growth > r.peak_live_bytes && r.peak_rss_growth > 0) {
+        fragmentation = 1.0 - static_cast<double>(r.peak_live_bytes) / static_cast<double>(r.peak_rss_growth);
+    }
+    std::printf("%-20s %10.3f %12.1f %14zu %14zu %8.3f %10zu\n",
+                name.c_str(), r.seconds * 1e3,
+                r.seconds > 0 ? r.operations / r.seconds / 1e6 : 0.0,
+                r.peak_live_bytes, r.peak_rss_growth, fragmentation, r.unmatched_frees);
+}
+
+// Прогон в дочернем процессе; результат приходит через pipe. Страницы,
+// которые предыдущие backend оставили резидентными, не скрывают рост
+// RSS следующего, и peak_rss_B с frag не зависят от порядка backend.
+// Без fork - прогон в этом процессе
+template <typename Backend>
+bool replay_isolated(const std::vector<allocation_trace::record>& trace, replay_result& result) {
+#if ALLOCATOR_REPLAY_FORK
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+    std::fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        int code = 1;
+        try {
+            replay_result child = replay<Backend>(trace);
+            if (write(fds[1], &child, sizeof(child)) == static_cast<ssize_t>(sizeof(child))) code = 0;
+        } catch (...) {
+        }
+        _exit(code);
+    }
+    close(fds[1]);
+    std::size_t received = 0;
+    auto* out = reinterpret_cast<char*>(&result);
+    while (received < sizeof(result)) {
+        ssize_t n = read(fds[0], out + received, sizeof(result) - received);
+        if (n <= 0) break;
+        received += static_cast<std::size_t>(n);
+    }
+    close(fds[0]);
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    return received == sizeof(result) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+#else
+    result = replay<Backend>(trace);
+    return true;
+#endif
+}
+
+enum class run_status { ok, unknown, failed };
+
+run_status run(const std::string& name, const std::vector<allocation_trace::record>& trace) {
+    replay_result result;
+    bool ok = false;
+    if (name == "std") ok = replay_isolated<std_backend>(trace, result);
+    else if (name == "my_allocator:64") ok = replay_isolated<arena_backend<64>>(trace, result);
+    else if (name == "my_allocator:1024") ok = replay_isolated<arena_backend<1024>>(trace, result);
+    else if (name == "my_allocator:16384") ok = replay_isolated<arena_backend<16384>>(trace, result);
+    else if (name == "pmr-pool") ok = replay_isolated<pmr_backend<std::pmr::unsynchronized_pool_resource>>(trace, result);
+    else if (name == "pmr-monotonic") ok = replay_isolated<pmr_backend<std::pmr::monotonic_buffer_resource>>(trace, result);
+    else return run_status::unknown;
+    if (!ok) return run_status::failed;
+    print(name, result);
+    return run_status::ok;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Использование: " << argv[0] << " <trace.bin> | --workload=SPEC [backend ...]\n";
+        return 1;
+    }
+
+    std::vector<allocation_trace::record> trace;
+    std::string source = argv[1];
+    if (source.compare(0, 11, "--workload=") == 0) {
+        workload::config config;
+        std::string error;
+        if (!config.parse(source.substr(11), error)) {
+            std::cerr << "Ошибка: " << error << "\n";
+            return 1;
+        }
+        trace = workload::to_trace(config);
+    } else if (!allocation_trace::load(argv[1], trace)) {
+        std::cerr << "Ошибка: не удалось прочитать трассу " << argv[1] << "\n";
+        return 1;
+    }
+
+    std::vector<std::string> backends;
+    for (int i = 2; i < argc; ++i) backends.emplace_back(argv[i]);
+    if (backends.empty()) {
+        backends = {"std", "my_allocator:64", "my_allocator:1024", "my_allocator:16384",
+                    "pmr-pool", "pmr-monotonic"};
+    }
+
+    std::cout << "Трасса: " << trace.size() << " записей\n";
+    std::printf("%-20s %10s %12s %14s %14s %8s %10s\n",
+                "backend", "time_ms", "Mops/s", "peak_live_B", "peak_rss_B", "frag", "unmatched");
+    for (const auto& name : backends) {
+        run_status status = run(name, trace);
+        if (status == run_status::unknown) {
+            std::cerr << "Ошибка: неизвестный backend " << name << "\n";
+            return 1;
+        }
+        if (status == run_status::failed) {
+            std::cerr << "Ошибка: прогон " << name << " завершился аварийно\n";
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,390 @@
+#ifndef WORKLOAD_GENERATOR_H
+#define WORKLOAD_GENERATOR_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <limits>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "allocation_trace.h"
+
+// Генератор синтетических потоков аллокаций. Поток задается строкой вида
+//   size=zipf:16:4096:1.1,life=exp:1000,threads=4:random,ops=1000000,seed=42
+// и при одинаковом seed воспроизводится полностью. Используются только
+// mt19937_64 и собственные преобразования: std::*_distribution дают
+// разные последовательности в разных стандартных библиотеках
+namespace workload {
+
+struct event {
+    enum kind : std::uint8_t { allocate = 1, deallocate = 2 };
+    kind op;
+    std::uint64_t id;        // Идентификатор блока; пара allocate/deallocate совпадает
+    std::uint32_t size;      // Байты
+    std::uint16_t thread;
+};
+
+class random_source {
+public:
+    explicit random_source(std::uint64_t seed) : engine_(seed) {}
+
+    // Равномерно в [0, 1)
+    double uniform() { return static_cast<double>(engine_() >> 11) * (1.0 / 9007199254740992.0); }
+
+    // Равномерно в [0, n)
+    std::uint64_t below(std::uint64_t n) { return n ? static_cast<std::uint64_t>(uniform() * static_cast<double>(n)) : 0; }
+
+    double exponential(double mean) { return -std::log(1.0 - uniform()) * mean; }
+
+private:
+    std::mt19937_64 engine_;
+};
+
+// Разбор "a:b:c" на поля
+inline std::vector<std::string> split(const std::string& s, char separator) {
+    std::vector<std::string> parts;
+    std::size_t begin = 0;
+    for (;;) {
+        std::size_t end = s.find(separator, begin);
+        parts.push_back(s.substr(begin, end == std::string::npos ? std::string::npos : end - begin));
+        if (end == std::string::npos) return parts;
+        begin = end + 1;
+    }
+}
+
+// Распределение размеров:
+//   fixed:N | uniform:MIN:MAX | zipf:MIN:MAX:S | emp:SIZExWEIGHT/SIZExWEIGHT/...
+// В zipf ранги - классы размеров с шагом 16 байт от MIN, меньшие чаще
+struct size_distribution {
+    enum kind { fixed, uniform, zipf, empirical };
+    kind type = fixed;
+    std::uint32_t min = 64;
+    std::uint32_t max = 64;
+    double exponent = 1.0;
+    std::vector<std::uint32_t> sizes;  // zipf и emp: значения
+    std::vector<double> cdf;           // zipf и emp: накопленные вероятности
+
+    bool parse(const std::string& spec) {
+        auto parts = split(spec, ':');
+        sizes.clear();
+        cdf.clear();
+        if (parts[0] == "fixed" && parts.size() == 2) {
+            type = fixed;
+            min = max = static_cast<std::uint32_t>(std::strtoul(parts[1].c_str(), nullptr, 10));
+            return min > 0;
+        }
+        if (parts[0] == "uniform" && parts.size() == 3) {
+            type = uniform;
+            min = static_cast<std::uint32_t>(std::strtoul(parts[1].c_str(), nullptr, 10));
+            max = static_cast<std::uint32_t>(std::strtoul(parts[2].c_str(), nullptr, 10));
+            return min > 0 && min <= max;
+        }
+        if (parts[0] == "zipf" && parts.size() == 4) {
+            type = zipf;
+            min = static_cast<std::uint32_t>(std::strtoul(parts[1].c_str(), nullptr, 10));
+            max = static_cast<std::uint32_t>(std::strtoul(parts[2].c_str(), nullptr, 10));
+            exponent = std::strtod(parts[3].c_str(), nullptr);
+            if (min == 0 || min > max) return false;
+            std::vector<double> weights;
+            for (std::uint32_t size = min, rank = 1; size <= max; size += 16, ++rank) {
+                sizes.push_back(size);
+                weights.push_back(1.0 / std::pow(static_cast<double>(rank), exponent));
+            }
+            build_cdf(weights);
+            return true;
+        }
+        if (parts[0] == "emp" && parts.size() == 2) {
+            type = empirical;
+            std::vector<double> weights;
+            for (const auto& bin : split(parts[1], '/')) {
+                auto pair = split(bin, 'x');
+                if (pair.size() != 2) return false;
+                sizes.push_back(static_cast<std::uint32_t>(std::strtoul(pair[0].c_str(), nullptr, 10)));
+                weights.push_back(std::strtod(pair[1].c_str(), nullptr));
+                if (sizes.back() == 0 || weights.back() <= 0.0) return false;
+            }
+            build_cdf(weights);
+            return !sizes.empty();
+        }
+        return false;
+    }
+
+    std::uint32_t sample(random_source& rng) const {
+        switch (type) {
+            case fixed: return min;
+            case uniform: return min + static_cast<std::uint32_t>(rng.below(max - min + 1));
+            default: {
+                double u = rng.uniform();
+                std::size_t i = static_cast<std::size_t>(std::upper_bound(cdf.begin(), cdf.end(), u) - cdf.begin());
+                return sizes[std::min(i, sizes.size() - 1)];
+            }
+        }
+    }
+
+private:
+    void build_cdf(const std::vector<double>& weights) {
+        double total = 0.0;
+        for (double w : weights) total += w;
+        double running = 0.0;
+        for (double w : weights) {
+            running += w / total;
+            cdf.push_back(running);
+        }
+    }
+};
+
+// Время жизни в шагах генератора (один шаг - одна аллокация):
+//   exp:MEAN | bimodal:SHORT:LONG:LONG_FRACTION | lifo:LIVE | fifo:LIVE
+// Для lifo/fifo освобождается последний/первый живой блок, а LIVE -
+// целевое число живых блоков
+struct lifetime_distribution {
+    enum kind { exponential, bimodal, lifo, fifo };
+    kind type = exponential;
+    double short_mean = 1000.0;
+    double long_mean = 0.0;
+    double long_fraction = 0.0;
+    std::size_t live_target = 1000;
+
+    bool parse(const std::string& spec) {
+        auto parts = split(spec, ':');
+        if (parts[0] == "exp" && parts.size() == 2) {
+            type = exponential;
+            short_mean = std::strtod(parts[1].c_str(), nullptr);
+            return short_mean > 0.0;
+        }
+        if (parts[0] == "bimodal" && parts.size() == 4) {
+            type = bimodal;
+            short_mean = std::strtod(parts[1].c_str(), nullptr);
+            long_mean = std::strtod(parts[2].c_str(), nullptr);
+            long_fraction = std::strtod(parts[3].c_str(), nullptr);
+            return short_mean > 0.0 && long_mean > 0.0 && long_fraction >= 0.0 && long_fraction <= 1.0;
+        }
+        if ((parts[0] == "lifo" || parts[0] == "fifo") && parts.size() == 2) {
+            type = parts[0] == "lifo" ? lifo : fifo;
+            live_target = std::strtoul(parts[1].c_str(), nullptr, 10);
+            return live_target > 0;
+        }
+        return false;
+    }
+};
+
+// Чередование потоков: N:rr (по кругу) | N:random | N:burst:LEN
+struct interleaving {
+    enum kind { round_robin, random, burst };
+    kind type = round_robin;
+    std::uint16_t threads = 1;
+    std::size_t burst_length = 64;
+
+    bool parse(const std::string& spec) {
+        auto parts = split(spec, ':');
+        // Номер потока в трассе 16-битный: больше UINT16_MAX не усекается, а отвергается
+        unsigned long count = std::strtoul(parts[0].c_str(), nullptr, 10);
+        if (count == 0 || count > std::numeric_limits<std::uint16_t>::max()) return false;
+        threads = static_cast<std::uint16_t>(count);
+        if (parts.size() == 1 || parts[1] == "rr") type = round_robin;
+        else if (parts[1] == "random") type = random;
+        else if (parts[1] == "burst" && parts.size() == 3) {
+            type = burst;
+            burst_length = std::strtoul(parts[2].c_str(), nullptr, 10);
+            return burst_length > 0;
+        } else return false;
+        return true;
+    }
+};
+
+struct config {
+    size_distribution sizes;
+    lifetime_distribution lifetimes;
+    interleaving threads;
+    std::size_t operations = 1000000;  // Количество аллокаций
+    std::uint64_t seed = 1;
+
+    // Разбор "key=value,key=value"; ключи size, life, threads, ops, seed
+    bool parse(const std::string& spec, std::string& error) {
+        for (const auto& item : split(spec, ',')) {
+            std::size_t eq = item.find('=');
+            if (eq == std::string::npos) {
+                error = "ожидалось key=value: " + item;
+                return false;
+            }
+            std::string key = item.substr(0, eq), value = item.substr(eq + 1);
+            bool ok = true;
+            if (key == "size") ok = sizes.parse(value);
+            else if (key == "life") ok = lifetimes.parse(value);
+            else if (key == "threads") ok = threads.parse(value);
+            else if (key == "ops") ok = (operations = std::strtoull(value.c_str(), nullptr, 10)) > 0;
+            else if (key == "seed") seed = std::strtoull(value.c_str(), nullptr, 10);
+            else ok = false;
+            if (!ok) {
+                error = "неверный параметр " + item;
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// Поток событий; next() возвращает false, когда все аллокации выданы
+// и все живые блоки освобождены
+class generator {
+public:
+    explicit generator(const config& cfg) : config_(cfg), rng_(cfg.seed) {}
+
+    bool next(event& out) {
+        if (pending_ < ready_.size()) {
+            out = ready_[pending_++];
+            return true;
+        }
+        ready_.clear();
+        pending_ = 0;
+        if (!step()) return false;
+        out = ready_[pending_++];
+        return true;
+    }
+
+private:
+    struct live_block {
+        std::uint64_t id;
+        std::uint32_t size;
+        std::uint16_t thread;
+    };
+
+    struct scheduled_free {
+        std::uint64_t due;
+        live_block block;
+        bool operator>(const scheduled_free& other) const {
+            return due != other.due ? due > other.due : block.id > other.block.id;
+        }
+    };
+
+    // Один шаг: освобождения, срок которых наступил, и одна аллокация
+    bool step() {
+        const auto& life = config_.lifetimes;
+        if (allocated_ < config_.operations) {
+            if (life.type == lifetime_distribution::lifo || life.type == lifetime_distribution::fifo) {
+                // Чем больше живых блоков относительно цели, тем вероятнее
+                // освобождение; на шаг приходится одна аллокация, поэтому
+                // при LIVE живых блоках (p_free = 1) их число не растет
+                double p_free = std::min(1.0, static_cast<double>(order_.size()) / static_cast<double>(life.live_target));
+                if (!order_.empty() && rng_.uniform() < p_free) {
+                    live_block block;
+                    if (life.type == lifetime_distribution::lifo) {
+                        block = order_.back();
+                        order_.pop_back();
+                    } else {
+                        block = order_.front();
+                        order_.pop_front();
+                    }
+                    emit_free(block);
+                }
+            } else {
+                while (!schedule_.empty() && schedule_.top().due <= allocated_) {
+                    emit_free(schedule_.top().block);
+                    schedule_.pop();
+                }
+            }
+
+            live_block block{allocated_, config_.sizes.sample(rng_), pick_thread()};
+            ready_.push_back({event::allocate, block.id, block.size, block.thread});
+            ++allocated_;
+
+            switch (life.type) {
+                case lifetime_distribution::exponential:
+                    schedule(block, rng_.exponential(life.short_mean));
+                    break;
+                case lifetime_distribution::bimodal:
+                    schedule(block, rng_.exponential(rng_.uniform() < life.long_fraction ? life.long_mean : life.short_mean));
+                    break;
+                default:
+                    order_.push_back(block);
+                    break;
+            }
+            return true;
+        }
+
+        // Аллокации закончились - освобождаем оставшееся в порядке сроков
+        if (!schedule_.empty()) {
+            emit_free(schedule_.top().block);
+            schedule_.pop();
+            return true;
+        }
+        if (!order_.empty()) {
+            live_block block;
+            if (life.type == lifetime_distribution::lifo) {
+                block = order_.back();
+                order_.pop_back();
+            } else {
+                block = order_.front();
+                order_.pop_front();
+            }
+            emit_free(block);
+            return true;
+        }
+        return false;
+    }
+
+    void schedule(const live_block& block, double lifetime) {
+        schedule_.push({allocated_ + static_cast<std::uint64_t>(lifetime), block});
+    }
+
+    void emit_free(const live_block& block) {
+        ready_.push_back({event::deallocate, block.id, block.size, block.thread});
+    }
+
+    std::uint16_t pick_thread() {
+        const auto& t = config_.threads;
+        switch (t.type) {
+            case interleaving::random:
+                return static_cast<std::uint16_t>(rng_.below(t.threads));
+            case interleaving::burst:
+                if (burst_left_ == 0) {
+                    current_thread_ = static_cast<std::uint16_t>(rng_.below(t.threads));
+                    burst_left_ = t.burst_length;
+                }
+                --burst_left_;
+                return current_thread_;
+            default:
+                return static_cast<std::uint16_t>(allocated_ % t.threads);
+        }
+    }
+
+    config config_;
+    random_source rng_;
+    std::uint64_t allocated_ = 0;
+    std::priority_queue<scheduled_free, std::vector<scheduled_free>, std::greater<scheduled_free>> schedule_;
+    std::deque<live_block> order_;   // lifo/fifo
+    std::vector<event> ready_;
+    std::size_t pending_ = 0;
+    std::uint16_t current_thread_ = 0;
+    std::size_t burst_left_ = 0;
+};
+
+// Поток целиком в формате трассы: идентификатор блока в поле address,
+// номер события в поле timestamp_ns. Такой поток принимает allocator_replay
+inline std::vector<allocation_trace::record> to_trace(const config& cfg) {
+    std::vector<allocation_trace::record> trace;
+    generator gen(cfg);
+    event e;
+    for (std::uint64_t index = 0; gen.next(e); ++index) {
+        allocation_trace::record rec;
+        rec.timestamp_ns = index;
+        rec.address = e.id + 1;  // 0 не используется как адрес
+        rec.size = e.size;
+        rec.thread = e.thread;
+        rec.kind = static_cast<std::uint8_t>(e.op == event::allocate ? allocation_trace::op::allocate
+                                                                     : allocation_trace::op::deallocate);
+        rec.reserved = 0;
+        trace.push_back(rec);
+    }
+    return trace;
+}
+
+} // namespace workload
+
+#endif
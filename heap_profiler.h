@@ -0,0 +1,267 @@
+#ifndef HEAP_PROFILER_H
+#define HEAP_PROFILER_H
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__has_include)
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define HEAP_PROFILER_HAS_BACKTRACE 1
+#endif
+#endif
+
+// Переключатель профилировщика кучи: -DMY_ALLOCATOR_HEAP_PROFILE=1 встраивает
+// выборку в my_allocator. Сама выборка включается во время выполнения
+// через heap_profiler::start()
+#ifndef MY_ALLOCATOR_HEAP_PROFILE
+#define MY_ALLOCATOR_HEAP_PROFILE 0
+#endif
+
+// Выборочный профилировщик живой кучи. В среднем одна выборка на
+// sample_period байт: интервал между выборками случаен (экспоненциальное
+// распределение), поэтому крупные блоки попадают в выборку чаще мелких.
+// Выборка запоминает стек и живет до deallocate. Профиль пишется в
+// текстовом формате heap profile gperftools (heap_v2), который читает
+// pprof: pprof --http=: ./allocator_lab heap.prof
+namespace heap_profiler {
+
+constexpr std::size_t default_sample_period = 512 * 1024;
+constexpr int max_frames = 64;
+
+namespace detail {
+
+// Состояние горячего пути - простые атомики без динамической инициализации
+inline std::atomic<std::size_t> sample_period{0};   // 0 - выключен
+inline std::atomic<std::uint32_t> generation{0};    // Меняется при каждом start()
+inline std::atomic<std::size_t> live_samples{0};
+
+// Счетный фильтр адресов живых выборок: ноль в ячейке - адрес точно
+// не в выборке, и deallocate обходится без mutex
+constexpr std::size_t filter_bits = 12;
+inline std::atomic<std::uint32_t> live_filter[std::size_t(1) << filter_bits];
+
+inline std::size_t filter_index(const void* p) noexcept {
+    auto key = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(p) >> 4);
+    return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> (64 - filter_bits));
+}
+
+struct live_sample {
+    std::size_t bytes;
+    std::size_t stack;  // Индекс в state::stacks
+};
+
+struct stack_record {
+    std::vector<void*> frames;
+    std::uint64_t allocations = 0;  // Все выборки стека с момента start()
+    std::uint64_t allocated_bytes = 0;
+};
+
+struct state {
+    std::mutex mutex;
+    std::unordered_map<const void*, live_sample> live;
+    std::vector<stack_record> stacks;
+    std::map<std::vector<void*>, std::size_t> stack_index;
+
+    static state& instance() {
+        static state* s = new state();  // Не разрушается: потоки могут освобождать после main
+        return *s;
+    }
+};
+
+// Счетчик байт до следующей выборки и генератор потока
+struct thread_state {
+    std::int64_t remaining;
+    std::uint64_t rng;
+    std::uint32_t generation;
+    bool busy;  // Защита от повторного входа из backtrace
+};
+
+inline thread_local thread_state tls{0, 0, 0, false};
+
+// Экспоненциальный интервал со средним period (xorshift64*)
+inline std::int64_t next_interval(thread_state& t, std::size_t period) noexcept {
+    t.rng ^= t.rng >> 12;
+    t.rng ^= t.rng << 25;
+    t.rng ^= t.rng >> 27;
+    std::uint64_t bits = (t.rng * 0x2545F4914F6CDD1Dull) >> 11;
+    double u = (static_cast<double>(bits) + 1.0) / 9007199254740992.0;  // (0, 1]
+    return static_cast<std::int64_t>(-std::log(u) * static_cast<double>(period)) + 1;
+}
+
+inline void attach(thread_state& t, std::size_t period, std::uint32_t gen) noexcept {
+    if (t.rng == 0) {
+        t.rng = reinterpret_cast<std::uintptr_t>(&t) * 0x9E3779B97F4A7C15ull | 1;
+    }
+    t.generation = gen;
+    t.remaining = next_interval(t, period);
+}
+
+inline void take_sample(const void* p, std::size_t bytes, std::size_t period) noexcept {
+    thread_state& t = tls;
+    t.remaining = next_interval(t, period);
+    if (t.busy) return;
+    t.busy = true;
+
+    void* frames[max_frames + 1];
+    int depth = 0;
+#if defined(HEAP_PROFILER_HAS_BACKTRACE)
+    depth = backtrace(frames, max_frames + 1);
+#endif
+    try {
+        // Первый кадр - сам take_sample
+        std::vector<void*> stack(frames + (depth > 0 ? 1 : 0), frames + depth);
+        state& s = state::instance();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto found = s.stack_index.find(stack);
+        std::size_t index;
+        if (found == s.stack_index.end()) {
+            index = s.stacks.size();
+            s.stacks.push_back({stack, 0, 0});
+            s.stack_index.emplace(std::move(stack), index);
+        } else {
+            index = found->second;
+        }
+        s.stacks[index].allocations += 1;
+        s.stacks[index].allocated_bytes += bytes;
+        auto inserted = s.live.insert({p, {bytes, index}});
+        if (inserted.second) {
+            live_filter[filter_index(p)].fetch_add(1, std::memory_order_relaxed);
+            live_samples.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            inserted.first->second = {bytes, index};  // Пропущенное освобождение
+        }
+    } catch (...) {
+        // Выборка теряется, но аллокация не должна падать из-за профилировщика
+    }
+    t.busy = false;
+}
+
+inline void release_sample(const void* p) noexcept {
+    state& s = state::instance();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    auto it = s.live.find(p);
+    if (it == s.live.end()) return;  // Ложное срабатывание фильтра
+    s.live.erase(it);
+    live_filter[filter_index(p)].fetch_sub(1, std::memory_order_relaxed);
+    live_samples.fetch_sub(1, std::memory_order_relaxed);
+}
+
+} // namespace detail
+
+// Включение выборки; профиль предыдущего запуска сбрасывается
+inline void start(std::size_t sample_period = default_sample_period) {
+    auto& s = detail::state::instance();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    for (const auto& entry : s.live) {
+        detail::live_filter[detail::filter_index(entry.first)].fetch_sub(1, std::memory_order_relaxed);
+    }
+    s.live.clear();
+    s.stacks.clear();
+    s.stack_index.clear();
+    detail::live_samples.store(0, std::memory_order_relaxed);
+    detail::generation.fetch_add(1, std::memory_order_relaxed);
+    detail::sample_period.store(sample_period ? sample_period : 1, std::memory_order_relaxed);
+}
+
+// Новые выборки прекращаются; живые продолжают сниматься при освобождении
+inline void stop() noexcept {
+    detail::sample_period.store(0, std::memory_order_relaxed);
+}
+
+inline bool enabled() noexcept {
+    return detail::sample_period.load(std::memory_order_relaxed) != 0;
+}
+
+// Учет операций аллокатора: быстрый путь - вычитание из счетчика потока
+inline void record_allocate(const void* p, std::size_t bytes) noexcept {
+    std::size_t period = detail::sample_period.load(std::memory_order_relaxed);
+    if (period == 0) return;
+    detail::thread_state& t = detail::tls;
+    std::uint32_t gen = detail::generation.load(std::memory_order_relaxed);
+    if (t.generation != gen) detail::attach(t, period, gen);
+    t.remaining -= static_cast<std::int64_t>(bytes);
+    if (t.remaining > 0) return;
+    detail::take_sample(p, bytes, period);
+}
+
+inline void record_deallocate(const void* p) noexcept {
+    if (detail::live_samples.load(std::memory_order_relaxed) == 0) return;
+    if (detail::live_filter[detail::filter_index(p)].load(std::memory_order_relaxed) == 0) return;
+    detail::release_sample(p);
+}
+
+// Профиль живой кучи в формате heap_v2: значения выборок без поправки,
+// pprof сам масштабирует их по периоду из заголовка
+inline void dump(std::ostream& out) {
+    auto& s = detail::state::instance();
+    std::vector<std::uint64_t> live_count, live_bytes;
+    std::vector<detail::stack_record> stacks;
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        stacks = s.stacks;
+        live_count.assign(stacks.size(), 0);
+        live_bytes.assign(stacks.size(), 0);
+        for (const auto& entry : s.live) {
+            live_count[entry.second.stack] += 1;
+            live_bytes[entry.second.stack] += entry.second.bytes;
+        }
+    }
+    std::size_t period = detail::sample_period.load(std::memory_order_relaxed);
+    if (period == 0) period = default_sample_period;
+
+    std::uint64_t total_count = 0, total_bytes = 0, total_allocs = 0, total_alloc_bytes = 0;
+    for (std::size_t i = 0; i < stacks.size(); ++i) {
+        total_count += live_count[i];
+        total_bytes += live_bytes[i];
+        total_allocs += stacks[i].allocations;
+        total_alloc_bytes += stacks[i].allocated_bytes;
+    }
+
+    char line[128];
+    std::snprintf(line, sizeof(line), "heap profile: %6llu: %8llu [%6llu: %8llu] @ heap_v2/%zu\n",
+                  static_cast<unsigned long long>(total_count), static_cast<unsigned long long>(total_bytes),
+                  static_cast<unsigned long long>(total_allocs), static_cast<unsigned long long>(total_alloc_bytes),
+                  period);
+    out << line;
+    for (std::size_t i = 0; i < stacks.size(); ++i) {
+        std::snprintf(line, sizeof(line), "%6llu: %8llu [%6llu: %8llu] @",
+                      static_cast<unsigned long long>(live_count[i]), static_cast<unsigned long long>(live_bytes[i]),
+                      static_cast<unsigned long long>(stacks[i].allocations),
+                      static_cast<unsigned long long>(stacks[i].allocated_bytes));
+        out << line;
+        for (void* frame : stacks[i].frames) {
+            std::snprintf(line, sizeof(line), " 0x%llx",
+                          static_cast<unsigned long long>(reinterpret_cast<std::uintptr_t>(frame)));
+            out << line;
+        }
+        out << "\n";
+    }
+
+    // Карта загруженных модулей - по ней pprof переводит адреса в символы
+    out << "\nMAPPED_LIBRARIES:\n";
+#if defined(__linux__)
+    std::ifstream maps("/proc/self/maps");
+    if (maps) out << maps.rdbuf();
+#endif
+}
+
+inline bool dump(const char* path) {
+    std::ofstream out(path);
+    if (!out) return false;
+    dump(out);
+    return static_cast<bool>(out);
+}
+
+} // namespace heap_profiler
+
+#endif
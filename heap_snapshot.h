@@ -0,0 +1,276 @@
+#ifndef HEAP_SNAPSHOT_H
+#define HEAP_SNAPSHOT_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <csignal>
+#include <fcntl.h>
+#include <thread>
+#include <unistd.h>
+#define HEAP_SNAPSHOT_HAS_SIGNALS 1
+#endif
+
+// Переключатель снимков кучи: -DMY_ALLOCATOR_SNAPSHOT=1 регистрирует каждую
+// арену my_allocator в общем реестре, и снимок может обойти все арены.
+// Аллокатор не потокобезопасен, поэтому в этом режиме allocate/deallocate
+// берут mutex арены (без конкуренции, пока снимок не снимается)
+#ifndef MY_ALLOCATOR_SNAPSHOT
+#define MY_ALLOCATOR_SNAPSHOT 0
+#endif
+
+// Снимок заполнения всех арен: по каждому чанку адрес, размер, живые
+// слоты и сводка карты занятости, плюс таблица фрагментации по размерам
+// слотов. По сигналу (SIGUSR2) снимок пишется в файл отдельным потоком:
+// обработчик только пишет байт в pipe, что безопасно в обработчике сигнала
+namespace heap_snapshot {
+
+// Состояние слота в карте занятости чанка
+enum slot_state : std::uint8_t {
+    slot_unused = 0,  // За границей заполнения чанка
+    slot_live = 1,
+    slot_free = 2,    // В списке освобожденных
+};
+
+struct chunk_report {
+    const void* address = nullptr;
+    std::size_t slots = 0;
+    std::size_t used = 0;        // Слотов под границей заполнения
+    std::size_t live = 0;        // used минус освобожденные; блоки из нескольких
+                                 // слотов после deallocate остаются живыми
+    std::string occupancy;       // Сводка карты занятости
+};
+
+struct arena_report {
+    const void* address = nullptr;
+    const char* type = "";
+    std::size_t slot_size = 0;
+    std::vector<chunk_report> chunks;
+};
+
+// Заполнение отчета арены; вызывается под mutex реестра
+using describe_fn = void (*)(const void* arena, arena_report& out);
+
+// Ширина сводки: карта чанка сжимается до этого числа знаков.
+// '#' - все слоты живые, '+' - живых больше половины, '.' - меньше,
+// '_' - только свободные, ' ' - не заполнено
+constexpr std::size_t occupancy_width = 64;
+
+inline std::string summarize(const std::vector<std::uint8_t>& slots) {
+    std::string out;
+    if (slots.empty()) return out;
+    std::size_t width = std::min(occupancy_width, slots.size());
+    out.reserve(width);
+    for (std::size_t i = 0; i < width; ++i) {
+        std::size_t begin = i * slots.size() / width;
+        std::size_t end = (i + 1) * slots.size() / width;
+        std::size_t live = 0, free = 0;
+        for (std::size_t j = begin; j < end; ++j) {
+            live += slots[j] == slot_live;
+            free += slots[j] == slot_free;
+        }
+        std::size_t total = end - begin;
+        if (live == total) out += '#';
+        else if (live * 2 > total) out += '+';
+        else if (live) out += '.';
+        else if (free) out += '_';
+        else out += ' ';
+    }
+    return out;
+}
+
+namespace detail {
+
+struct registry {
+    std::mutex mutex;
+    std::vector<std::pair<const void*, describe_fn>> arenas;
+
+    static registry& instance() {
+        static registry* r = new registry();  // Не разрушается: арены могут жить после main
+        return *r;
+    }
+};
+
+} // namespace detail
+
+inline void register_arena(const void* arena, describe_fn describe) noexcept {
+    auto& r = detail::registry::instance();
+    try {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.arenas.emplace_back(arena, describe);
+    } catch (...) {
+        // Арена просто не попадет в снимок
+    }
+}
+
+inline void unregister_arena(const void* arena) noexcept {
+    auto& r = detail::registry::instance();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto it = std::find_if(r.arenas.begin(), r.arenas.end(),
+                           [&](const std::pair<const void*, describe_fn>& entry) { return entry.first == arena; });
+    if (it != r.arenas.end()) {
+        *it = r.arenas.back();
+        r.arenas.pop_back();
+    }
+}
+
+// Текстовый снимок всех зарегистрированных арен
+inline void write(std::ostream& out) {
+    std::vector<arena_report> reports;
+    {
+        auto& r = detail::registry::instance();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        reports.resize(r.arenas.size());
+        for (std::size_t i = 0; i < r.arenas.size(); ++i) {
+            reports[i].address = r.arenas[i].first;
+            r.arenas[i].second(r.arenas[i].first, reports[i]);
+        }
+    }
+
+    struct size_class {
+        std::size_t arenas = 0, chunks = 0;
+        std::uint64_t reserved = 0, live = 0, free = 0, unused = 0;
+    };
+    std::map<std::size_t, size_class> classes;
+
+    char line[256];
+    std::snprintf(line, sizeof(line), "# allocator_lab heap snapshot: time %lld, arenas %zu\n",
+                  static_cast<long long>(std::time(nullptr)), reports.size());
+    out << line
+        << "# occupancy: '#' all live, '+' mostly live, '.' partly live, '_' freed, ' ' unused\n";
+    for (const arena_report& arena : reports) {
+        size_class& cls = classes[arena.slot_size];
+        ++cls.arenas;
+        std::uint64_t reserved = 0, live = 0;
+        for (const chunk_report& chunk : arena.chunks) {
+            reserved += chunk.slots * arena.slot_size;
+            live += chunk.live * arena.slot_size;
+            cls.free += (chunk.used - chunk.live) * arena.slot_size;
+            cls.unused += (chunk.slots - chunk.used) * arena.slot_size;
+        }
+        cls.chunks += arena.chunks.size();
+        cls.reserved += reserved;
+        cls.live += live;
+        if (arena.chunks.empty()) continue;
+
+        std::snprintf(line, sizeof(line), "arena %p type %s slot %zu chunks %zu reserved %llu live %llu\n",
+                      arena.address, arena.type, arena.slot_size, arena.chunks.size(),
+                      static_cast<unsigned long long>(reserved), static_cast<unsigned long long>(live));
+        out << line;
+        for (const chunk_report& chunk : arena.chunks) {
+            std::snprintf(line, sizeof(line), "  chunk %p slots %zu used %zu live %zu [",
+                          chunk.address, chunk.slots, chunk.used, chunk.live);
+            out << line << chunk.occupancy << "]\n";
+        }
+    }
+
+    out << "\n# fragmentation by slot size\n";
+    std::snprintf(line, sizeof(line), "%10s %8s %8s %14s %14s %14s %14s %14s\n",
+                  "slot", "arenas", "chunks", "reserved", "live", "freed", "unused", "fragmentation");
+    out << line;
+    for (const auto& entry : classes) {
+        const size_class& cls = entry.second;
+        double fragmentation = cls.reserved ? 1.0 - static_cast<double>(cls.live) / static_cast<double>(cls.reserved) : 0.0;
+        std::snprintf(line, sizeof(line), "%10zu %8zu %8zu %14llu %14llu %14llu %14llu %13.1f%%\n",
+                      entry.first, cls.arenas, cls.chunks,
+                      static_cast<unsigned long long>(cls.reserved), static_cast<unsigned long long>(cls.live),
+                      static_cast<unsigned long long>(cls.free), static_cast<unsigned long long>(cls.unused),
+                      fragmentation * 100.0);
+        out << line;
+    }
+}
+
+inline bool dump(const char* path) {
+    std::ofstream out(path);
+    if (!out) return false;
+    write(out);
+    return static_cast<bool>(out);
+}
+
+#if defined(HEAP_SNAPSHOT_HAS_SIGNALS)
+namespace detail {
+
+inline int signal_pipe[2] = {-1, -1};
+
+inline void on_signal(int) {
+    // Только async-signal-safe вызовы: байт в pipe будит поток записи
+    int saved = errno;
+    char byte = 1;
+    ssize_t written = ::write(signal_pipe[1], &byte, 1);
+    (void)written;  // Pipe полон - снимок уже запрошен
+    errno = saved;
+}
+
+inline void dumper(std::string directory) {
+    unsigned sequence = 1;  // Номера снимков с 1
+    for (;;) {
+        char byte;
+        ssize_t got = ::read(signal_pipe[0], &byte, 1);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return;
+        std::string path = directory + "/allocator_lab." + std::to_string(::getpid()) +
+                           "." + std::to_string(sequence++) + ".heap";
+        bool written = false;
+        try {
+            written = dump(path.c_str());
+        } catch (...) {
+        }
+        if (written) {
+            std::fprintf(stderr, "heap snapshot: %s\n", path.c_str());
+        } else {
+            std::fprintf(stderr, "heap snapshot: не удалось записать %s\n", path.c_str());
+        }
+    }
+}
+
+} // namespace detail
+#endif
+
+// Снимок по сигналу: файлы directory/allocator_lab.<pid>.<n>.heap, n с 1.
+// Повторный вызов ничего не меняет; false - сигналы недоступны
+inline bool install_signal_handler(const char* directory = ".", int signal_number =
+#if defined(HEAP_SNAPSHOT_HAS_SIGNALS)
+                                   SIGUSR2
+#else
+                                   0
+#endif
+                                   ) {
+#if defined(HEAP_SNAPSHOT_HAS_SIGNALS)
+    static std::once_flag once;
+    static bool installed = false;
+    std::call_once(once, [&] {
+        int* fds = detail::signal_pipe;
+        if (::pipe(fds) != 0) return;
+        for (int i = 0; i < 2; ++i) ::fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+        ::fcntl(fds[1], F_SETFL, ::fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+
+        std::thread(detail::dumper, std::string(directory ? directory : ".")).detach();
+
+        struct sigaction action {};
+        action.sa_handler = detail::on_signal;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESTART;
+        installed = ::sigaction(signal_number, &action, nullptr) == 0;
+    });
+    return installed;
+#else
+    (void)directory;
+    (void)signal_number;
+    return false;
+#endif
+}
+
+} // namespace heap_snapshot
+
+#endif
@@ -0,0 +1,278 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define LATENCY_HAS_RDTSC 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define LATENCY_HAS_RDTSC 1
+#else
+#define LATENCY_HAS_RDTSC 0
+#endif
+
+// Переключатель замеров: -DMY_ALLOCATOR_LATENCY=1 встраивает запись
+// латентности в my_allocator::allocate/deallocate и
+// my_container::push_back/emplace_back/clear
+#ifndef MY_ALLOCATOR_LATENCY
+#define MY_ALLOCATOR_LATENCY 0
+#endif
+
+// Гистограмма в стиле HDR: логарифмические группы по степеням двойки,
+// внутри группы 2^sub_bucket_bits линейных корзин (точность ~3%)
+class latency_histogram {
+public:
+    static constexpr unsigned sub_bucket_bits = 5;
+    static constexpr std::size_t sub_buckets = std::size_t(1) << sub_bucket_bits;
+    static constexpr std::size_t bucket_count = (64 - sub_bucket_bits + 1) * sub_buckets;
+
+    static std::size_t index_of(std::uint64_t value) noexcept {
+        if (value < sub_buckets) return static_cast<std::size_t>(value);
+        unsigned msb = highest_bit(value);
+        unsigned shift = msb - sub_bucket_bits;
+        std::size_t top = static_cast<std::size_t>(value >> shift);  // [sub_buckets, 2 * sub_buckets)
+        return (shift + 1) * sub_buckets + (top - sub_buckets);
+    }
+
+    // Середина диапазона значений корзины
+    static std::uint64_t value_of(std::size_t index) noexcept {
+        if (index < sub_buckets) return index;
+        std::size_t group = index >> sub_bucket_bits;
+        std::uint64_t low = (sub_buckets + (index & (sub_buckets - 1)));
+        unsigned shift = static_cast<unsigned>(group - 1);
+        return (low << shift) + ((std::uint64_t(1) << shift) >> 1);
+    }
+
+    void record(std::uint64_t value) noexcept {
+        ++counts_[index_of(value)];
+        ++total_;
+        max_ = std::max(max_, value);
+    }
+
+    void add(std::size_t index, std::uint64_t count) noexcept {
+        counts_[index] += count;
+        total_ += count;
+    }
+
+    void merge(const latency_histogram& other) noexcept {
+        for (std::size_t i = 0; i < bucket_count; ++i) counts_[i] += other.counts_[i];
+        total_ += other.total_;
+        max_ = std::max(max_, other.max_);
+    }
+
+    void set_max(std::uint64_t value) noexcept { max_ = std::max(max_, value); }
+
+    std::uint64_t total() const noexcept { return total_; }
+    std::uint64_t max() const noexcept { return max_; }
+
+    // Значение, не меньше которого q-я доля записей (q в [0, 1])
+    std::uint64_t percentile(double q) const noexcept {
+        if (total_ == 0) return 0;
+        std::uint64_t rank = static_cast<std::uint64_t>(q * static_cast<double>(total_ - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < bucket_count; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) return std::min(value_of(i), max_);
+        }
+        return max_;
+    }
+
+private:
+    static unsigned highest_bit(std::uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#else
+        unsigned bit = 0;
+        while (value >>= 1) ++bit;
+        return bit;
+#endif
+    }
+
+    std::array<std::uint64_t, bucket_count> counts_{};
+    std::uint64_t total_ = 0;
+    std::uint64_t max_ = 0;
+};
+
+namespace latency {
+
+enum class operation : std::size_t {
+    allocate,
+    deallocate,
+    push_back,
+    clear,
+    count_
+};
+
+constexpr std::size_t operation_count = static_cast<std::size_t>(operation::count_);
+
+inline const char* name(operation op) noexcept {
+    switch (op) {
+        case operation::allocate: return "allocate";
+        case operation::deallocate: return "deallocate";
+        case operation::push_back: return "push_back";
+        case operation::clear: return "clear";
+        default: return "?";
+    }
+}
+
+// Метка времени в тиках: rdtsc на x86, иначе steady_clock в наносекундах
+inline std::uint64_t now() noexcept {
+#if LATENCY_HAS_RDTSC
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// Наносекунд в одном тике; для rdtsc калибруется один раз по steady_clock
+inline double ns_per_tick() {
+#if LATENCY_HAS_RDTSC
+    static const double value = [] {
+        auto wall_start = std::chrono::steady_clock::now();
+        std::uint64_t tick_start = now();
+        while (std::chrono::steady_clock::now() - wall_start < std::chrono::milliseconds(20)) {
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - wall_start).count();
+        std::uint64_t ticks = now() - tick_start;
+        return ticks ? ns / static_cast<double>(ticks) : 1.0;
+    }();
+    return value;
+#else
+    return 1.0;
+#endif
+}
+
+namespace detail {
+
+// Гистограммы одного потока. Пишет только владелец (load + store без RMW),
+// снимок читает другой поток - поэтому atomic с relaxed
+struct thread_histograms {
+    std::atomic<std::uint64_t> counts[operation_count][latency_histogram::bucket_count] = {};
+    std::atomic<std::uint64_t> max[operation_count] = {};
+};
+
+// Блоки не освобождаются и переходят к следующим потокам, как в allocator_stats.h
+struct registry {
+    std::mutex mutex;
+    std::vector<thread_histograms*> blocks;
+    std::vector<thread_histograms*> free_blocks;
+
+    static registry& instance() {
+        static registry* r = new registry();
+        return *r;
+    }
+};
+
+inline thread_local thread_histograms* tls_histograms = nullptr;
+
+struct thread_slot {
+    ~thread_slot() {
+        registry& r = registry::instance();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.free_blocks.push_back(tls_histograms);
+        tls_histograms = nullptr;
+    }
+};
+
+inline thread_histograms* attach() noexcept {
+    registry& r = registry::instance();
+    try {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        if (!r.free_blocks.empty()) {
+            tls_histograms = r.free_blocks.back();
+            r.free_blocks.pop_back();
+        } else {
+            tls_histograms = new thread_histograms();
+            r.blocks.push_back(tls_histograms);
+        }
+    } catch (...) {
+        return nullptr;  // Без памяти под гистограмму замер теряется
+    }
+    thread_local thread_slot slot;
+    (void)slot;
+    return tls_histograms;
+}
+
+inline void bump(std::atomic<std::uint64_t>& counter) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+} // namespace detail
+
+// Запись длительности операции, начатой в момент start (тики)
+inline void record(operation op, std::uint64_t start) noexcept {
+    std::uint64_t elapsed = now() - start;
+    detail::thread_histograms* h = detail::tls_histograms;
+    if (!h && !(h = detail::attach())) return;
+    std::size_t i = static_cast<std::size_t>(op);
+    detail::bump(h->counts[i][latency_histogram::index_of(elapsed)]);
+    if (elapsed > h->max[i].load(std::memory_order_relaxed)) {
+        h->max[i].store(elapsed, std::memory_order_relaxed);
+    }
+}
+
+// Замер области видимости
+class scope {
+public:
+    explicit scope(operation op) noexcept : op_(op), start_(now()) {}
+    ~scope() { record(op_, start_); }
+
+    scope(const scope&) = delete;
+    scope& operator=(const scope&) = delete;
+
+private:
+    operation op_;
+    std::uint64_t start_;
+};
+
+// Сводная гистограмма операции по всем потокам (в тиках)
+inline latency_histogram snapshot(operation op) {
+    latency_histogram result;
+    auto& r = detail::registry::instance();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::size_t i = static_cast<std::size_t>(op);
+    for (const auto* h : r.blocks) {
+        for (std::size_t b = 0; b < latency_histogram::bucket_count; ++b) {
+            std::uint64_t count = h->counts[i][b].load(std::memory_order_relaxed);
+            if (count) result.add(b, count);
+        }
+        result.set_max(h->max[i].load(std::memory_order_relaxed));
+    }
+    return result;
+}
+
+// Таблица p50/p99/p99.9/p99.99/max в наносекундах по всем операциям
+inline void print(std::ostream& out) {
+    double scale = ns_per_tick();
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-12s %12s %10s %10s %10s %10s %12s\n",
+                  "operation", "count", "p50_ns", "p99_ns", "p99.9_ns", "p99.99_ns", "max_ns");
+    out << line;
+    for (std::size_t i = 0; i < operation_count; ++i) {
+        auto op = static_cast<operation>(i);
+        latency_histogram h = snapshot(op);
+        if (h.total() == 0) continue;
+        std::snprintf(line, sizeof(line), "%-12s %12llu %10.0f %10.0f %10.0f %10.0f %12.0f\n",
+                      name(op), static_cast<unsigned long long>(h.total()),
+                      h.percentile(0.5) * scale, h.percentile(0.99) * scale,
+                      h.percentile(0.999) * scale, h.percentile(0.9999) * scale,
+                      h.max() * scale);
+        out << line;
+    }
+}
+
+} // namespace latency
+
+#endif
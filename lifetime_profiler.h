@@ -0,0 +1,224 @@
+#ifndef LIFETIME_PROFILER_H
+#define LIFETIME_PROFILER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "allocation_tags.h"
+#include "latency_histogram.h"
+
+// Переключатель профиля времени жизни: -DMY_ALLOCATOR_LIFETIME=1 встраивает
+// запись времени allocate/deallocate в my_allocator. Объекты группируются
+// по тегу аллокатора (allocation_tags.h), поэтому режим включает и теги
+#ifndef MY_ALLOCATOR_LIFETIME
+#define MY_ALLOCATOR_LIFETIME 0
+#endif
+
+// Профиль времени жизни объектов по тегам: гистограмма времени жизни,
+// доля освобождений в порядке LIFO и рекомендация по размещению.
+// Режим профилирования: каждая операция берет общий mutex
+namespace lifetime_profiler {
+
+enum class placement {
+    bump_arena,    // Стековый порядок, короткая жизнь или без освобождений
+    pool,          // Блоки одного размера, освобождаемые вразнобой
+    general_heap,  // Долгоживущие блоки разных размеров
+};
+
+inline const char* name(placement p) noexcept {
+    switch (p) {
+        case placement::bump_arena: return "bump arena";
+        case placement::pool: return "pool";
+        case placement::general_heap: return "general heap";
+        default: return "?";
+    }
+}
+
+// Пороги рекомендации
+constexpr double lifo_threshold = 0.8;               // Доля LIFO для арены
+constexpr std::uint64_t short_lifetime_ns = 100000;  // p90 короче - арена на фазу
+
+// Итог по одному тегу; времена в наносекундах
+struct site_lifetime {
+    std::string name;
+    std::uint64_t allocations = 0;
+    std::uint64_t deallocations = 0;
+    std::uint64_t live = 0;
+    double lifo_fraction = 0.0;   // Освобожден самый молодой живой блок тега
+    std::uint64_t p50_ns = 0;
+    std::uint64_t p90_ns = 0;
+    std::uint64_t p99_ns = 0;
+    std::uint64_t max_ns = 0;
+    std::size_t min_bytes = 0;
+    std::size_t max_bytes = 0;
+    placement recommendation = placement::general_heap;
+};
+
+namespace detail {
+
+struct live_block {
+    std::uint64_t start;     // Тики latency::now()
+    std::uint64_t sequence;  // Порядковый номер в теге
+    std::uint16_t tag;
+};
+
+struct site {
+    std::unique_ptr<latency_histogram> lifetimes;  // В тиках; создается при первом освобождении
+    std::set<std::uint64_t> live_sequences;        // Для проверки порядка LIFO
+    std::uint64_t next_sequence = 0;
+    std::uint64_t allocations = 0;
+    std::uint64_t deallocations = 0;
+    std::uint64_t lifo_deallocations = 0;
+    std::size_t min_bytes = 0;
+    std::size_t max_bytes = 0;
+};
+
+struct state {
+    std::mutex mutex;
+    std::unordered_map<const void*, live_block> live;
+    std::vector<site> sites = std::vector<site>(allocation_tag::max_tags);
+
+    static state& instance() {
+        static state* s = new state();  // Не разрушается: освобождения возможны после main
+        return *s;
+    }
+};
+
+} // namespace detail
+
+// Учет операций аллокатора
+inline void record_allocate(allocation_tag tag, const void* p, std::size_t bytes) noexcept {
+    std::uint64_t now = latency::now();
+    auto& s = detail::state::instance();
+    try {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        detail::site& site = s.sites[tag.id()];
+        std::uint64_t sequence = site.next_sequence++;
+        auto inserted = s.live.insert({p, {now, sequence, tag.id()}});
+        if (!inserted.second) {
+            // Пропущенное освобождение: старая запись заменяется
+            s.sites[inserted.first->second.tag].live_sequences.erase(inserted.first->second.sequence);
+            inserted.first->second = {now, sequence, tag.id()};
+        }
+        site.live_sequences.insert(sequence);
+        site.min_bytes = site.allocations ? std::min(site.min_bytes, bytes) : bytes;
+        site.max_bytes = std::max(site.max_bytes, bytes);
+        ++site.allocations;
+    } catch (...) {
+        // Профиль теряет запись, но аллокация не должна падать
+    }
+}
+
+inline void record_deallocate(const void* p) noexcept {
+    std::uint64_t now = latency::now();
+    auto& s = detail::state::instance();
+    try {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto it = s.live.find(p);
+        if (it == s.live.end()) return;  // Выделено до включения профиля
+        detail::live_block block = it->second;
+        s.live.erase(it);
+
+        detail::site& site = s.sites[block.tag];
+        if (!site.live_sequences.empty() && *site.live_sequences.rbegin() == block.sequence) {
+            ++site.lifo_deallocations;
+        }
+        site.live_sequences.erase(block.sequence);
+        if (!site.lifetimes) site.lifetimes = std::make_unique<latency_histogram>();
+        site.lifetimes->record(now - block.start);
+        ++site.deallocations;
+    } catch (...) {
+    }
+}
+
+// Рекомендация по размещению для собранного профиля
+inline placement recommend(const site_lifetime& site) noexcept {
+    if (site.deallocations == 0) return placement::bump_arena;  // Живут до конца - хватит арены
+    if (site.lifo_fraction >= lifo_threshold) return placement::bump_arena;
+    if (site.p90_ns <= short_lifetime_ns && site.live * 10 <= site.allocations) return placement::bump_arena;
+    if (site.min_bytes == site.max_bytes) return placement::pool;
+    return placement::general_heap;
+}
+
+// Итоги по тегам, по убыванию числа аллокаций
+inline std::vector<site_lifetime> report() {
+    auto& s = detail::state::instance();
+    double ns_per_tick = latency::ns_per_tick();
+    auto to_ns = [&](std::uint64_t ticks) {
+        return static_cast<std::uint64_t>(static_cast<double>(ticks) * ns_per_tick);
+    };
+
+    std::vector<site_lifetime> result;
+    std::lock_guard<std::mutex> lock(s.mutex);
+    for (std::size_t id = 0; id < s.sites.size(); ++id) {
+        const detail::site& site = s.sites[id];
+        if (site.allocations == 0) continue;
+        site_lifetime entry;
+        entry.name = allocation_tags::name_of(static_cast<std::uint16_t>(id));
+        entry.allocations = site.allocations;
+        entry.deallocations = site.deallocations;
+        entry.live = site.live_sequences.size();
+        if (site.deallocations) {
+            entry.lifo_fraction = static_cast<double>(site.lifo_deallocations) / static_cast<double>(site.deallocations);
+        }
+        if (site.lifetimes) {
+            entry.p50_ns = to_ns(site.lifetimes->percentile(0.50));
+            entry.p90_ns = to_ns(site.lifetimes->percentile(0.90));
+            entry.p99_ns = to_ns(site.lifetimes->percentile(0.99));
+            entry.max_ns = to_ns(site.lifetimes->max());
+        }
+        entry.min_bytes = site.min_bytes;
+        entry.max_bytes = site.max_bytes;
+        entry.recommendation = recommend(entry);
+        result.push_back(std::move(entry));
+    }
+    std::sort(result.begin(), result.end(), [](const site_lifetime& a, const site_lifetime& b) {
+        return a.allocations > b.allocations;
+    });
+    return result;
+}
+
+inline void print(std::ostream& out) {
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-40s %10s %8s %6s %10s %10s %10s %12s  %s\n",
+                  "tag", "allocs", "live", "lifo", "p50 ns", "p90 ns", "p99 ns", "bytes", "placement");
+    out << line;
+    for (const auto& site : report()) {
+        char bytes[32];
+        if (site.min_bytes == site.max_bytes) {
+            std::snprintf(bytes, sizeof(bytes), "%zu", site.min_bytes);
+        } else {
+            std::snprintf(bytes, sizeof(bytes), "%zu-%zu", site.min_bytes, site.max_bytes);
+        }
+        std::snprintf(line, sizeof(line), "%-40.40s %10llu %8llu %5.0f%% %10llu %10llu %10llu %12s  %s\n",
+                      site.name.c_str(),
+                      static_cast<unsigned long long>(site.allocations),
+                      static_cast<unsigned long long>(site.live),
+                      site.lifo_fraction * 100.0,
+                      static_cast<unsigned long long>(site.p50_ns),
+                      static_cast<unsigned long long>(site.p90_ns),
+                      static_cast<unsigned long long>(site.p99_ns),
+                      bytes, name(site.recommendation));
+        out << line;
+    }
+}
+
+// Сброс профиля; блоки, выделенные до сброса, при освобождении не учитываются
+inline void reset() {
+    auto& s = detail::state::instance();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.live.clear();
+    for (auto& site : s.sites) site = detail::site();
+}
+
+} // namespace lifetime_profiler
+
+#endif
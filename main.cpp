@@ -1,8 +1,14 @@
+#include <cstdlib>
 #include <iostream>
 #include <map>
 #include "my_allocator.h"
 #include "my_container.h"
 
+// Отчет о расходе памяти в конце вывода (опция ALLOCATOR_LAB_REPORT)
+#ifndef MY_ALLOCATOR_REPORT
+#define MY_ALLOCATOR_REPORT 0
+#endif
+
 int factorial(int n) {
     int result = 1;
     for (int i = 2; i <= n; ++i) {
@@ -12,6 +18,28 @@ int factorial(int n) {
 }
 
 int main() {
+#if MY_ALLOCATOR_TRACE
+    // запись трассы аллокаций, если задан файл
+    if (const char* trace_path = std::getenv("ALLOCATOR_LAB_TRACE")) {
+        allocation_trace::start(trace_path);
+    }
+#endif
+#if MY_ALLOCATOR_TIMELINE
+    // временная шкала для chrome://tracing / Perfetto, если задан файл
+    const char* timeline_path = std::getenv("ALLOCATOR_LAB_TIMELINE");
+    if (timeline_path) {
+        timeline_trace::start();
+    }
+#endif
+#if MY_ALLOCATOR_HEAP_PROFILE
+    // выборочный профиль кучи: период выборки в байтах - ALLOCATOR_LAB_HEAP_SAMPLE
+    const char* heap_profile_path = std::getenv("ALLOCATOR_LAB_HEAP_PROFILE");
+    if (heap_profile_path) {
+        const char* period = std::getenv("ALLOCATOR_LAB_HEAP_SAMPLE");
+        heap_profiler::start(period ? std::strtoul(period, nullptr, 10) : heap_profiler::default_sample_period);
+    }
+#endif
+    
     try {
         std::cout << "Стандартный map:\n";
         std::map<int, int> map1;
@@ -29,7 +57,8 @@ int main() {
         // создание std::map с аллокатором
         std::cout << "\nСтандартный map с моим аллокатором:\n";
         using MapAllocator = my_allocator<std::pair<const int, int>, 10>;
-        std::map<int, int, std::less<int>, MapAllocator> map2;
+        // явный тег: аллокатор по умолчанию map создает в заголовке STL
+        std::map<int, int, std::less<int>, MapAllocator> map2(MapAllocator(allocation_tag::named("map2")));
         
         // заполнение 10 элементами
         for (int i = 0; i < 10; ++i) {
@@ -76,10 +105,61 @@ int main() {
         }
         std::cout << "\n";
         
+#if MY_ALLOCATOR_REPORT
+        // расход памяти узлами контейнера
+        auto usage = container2.memory_usage();
+        std::cout << "\nУзлы: " << usage.elements << " x " << usage.node_size
+                  << " байт, накладные расходы на элемент: " << usage.overhead_per_element << " байт\n";
+#endif
+        
+#if MY_ALLOCATOR_LATENCY
+        // латентность операций
+        std::cout << "\n";
+        latency::print(std::cout);
+#endif
+        
+#if MY_ALLOCATOR_HEAP_PROFILE
+        // профиль пишется, пока контейнеры еще живы
+        if (heap_profile_path && !heap_profiler::dump(heap_profile_path)) {
+            std::cerr << "Ошибка: не удалось записать " << heap_profile_path << "\n";
+        }
+#endif
+        
+#if MY_ALLOCATOR_TAGS
+        // крупнейшие потребители памяти по тегам
+        std::cout << "\n";
+        allocation_tags::dump(std::cout);
+#endif
+        
+#if MY_ALLOCATOR_REPORT && MY_ALLOCATOR_STATS
+        // суммарная статистика всех экземпляров my_allocator
+        auto stats = allocator_global_stats();
+        std::cout << "my_allocator: allocate " << stats.allocate_calls
+                  << ", живых байт " << stats.live_bytes()
+                  << ", зарезервировано " << stats.reserved_bytes() << "\n";
+#endif
+        
     } catch (const std::exception& e) {
         std::cerr << "Ошибка: " << e.what() << std::endl;
         return 1;
     }
     
+#if MY_ALLOCATOR_LIFETIME
+    // время жизни узлов - после разрушения контейнеров
+    std::cout << "\n";
+    lifetime_profiler::print(std::cout);
+#endif
+    
+#if MY_ALLOCATOR_TIMELINE
+    // после разрушения контейнеров, чтобы попало освобождение арен
+    if (timeline_path && !timeline_trace::flush(timeline_path)) {
+        std::cerr << "Ошибка: не удалось записать " << timeline_path << "\n";
+    }
+#endif
+    
+#if MY_ALLOCATOR_TRACE
+    allocation_trace::stop();
+#endif
+    
     return 0;
 }
\ No newline at end of file
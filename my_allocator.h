@@ -1,16 +1,145 @@
 #ifndef MY_ALLOCATOR_H
 #define MY_ALLOCATOR_H
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <cstddef>
+#include <cstring>
 #include <type_traits>
+#include <typeinfo>
 #include <limits>
 #include <stdexcept>
+#include <utility>
+#include "allocation_guard.h"
+#include "allocator_policies.h"
+#include "allocator_observer.h"
+#include "allocator_probes.h"
+#include "allocator_stats.h"
+#include "allocation_trace.h"
+#include "allocation_tags.h"
+#include "heap_profiler.h"
+#include "heap_snapshot.h"
+#include "lifetime_profiler.h"
+#include "latency_histogram.h"
+#include "timeline_trace.h"
+
+// Холодные пути (новый чанк, поиск арены) не встраиваются в allocate и
+// deallocate, чтобы не раздувать быстрый путь
+#if defined(__GNUC__) || defined(__clang__)
+#define MY_ALLOCATOR_COLD __attribute__((noinline, cold))
+#elif defined(_MSC_VER)
+#define MY_ALLOCATOR_COLD __declspec(noinline)
+#else
+#define MY_ALLOCATOR_COLD
+#endif
+
+namespace my_allocator_detail {
+
+// Арены всех копий одного аллокатора, по одной на тип элементов.
+// Копии и rebind-копии разделяют семейство: память, выделенную через
+// временную копию (так делают deque и unordered-контейнеры), можно
+// освободить через любую другую, и живет она, пока жива хоть одна копия.
+// Поиск арены - холодный путь, раз на копию; блокировка - Mutex политики
+// threading: у single_threaded это null_mutex, у mutex_threaded - std::mutex
+template <typename Mutex>
+class arena_family {
+public:
+    template <typename Arena>
+    Arena* find() const noexcept {
+        std::lock_guard<Mutex> lock(mutex_);
+        return find_locked<Arena>();
+    }
+
+    template <typename Arena>
+    Arena& get() {
+        std::lock_guard<Mutex> lock(mutex_);
+        if (Arena* existing = find_locked<Arena>()) return *existing;
+        auto created = std::make_shared<Arena>();
+        arenas_.emplace_back(&key<Arena>, created);
+        return *created;
+    }
+
+private:
+    template <typename Arena>
+    Arena* find_locked() const noexcept {
+        for (const auto& entry : arenas_) {
+            if (entry.first == &key<Arena>) return static_cast<Arena*>(entry.second.get());
+        }
+        return nullptr;
+    }
+
+    template <typename Arena>
+    static inline const char key = 0;  // Адрес - идентификатор типа арены
+
+    mutable Mutex mutex_;
+    std::vector<std::pair<const void*, std::shared_ptr<void>>> arenas_;
+};
+
+// Тег экземпляра; без учета по тегам - пустая база
+template <bool Enabled>
+struct tag_holder {
+    allocation_tag tag() const noexcept { return allocation_tag(); }
+    void set_tag(allocation_tag) noexcept {}
+};
+
+template <>
+struct tag_holder<true> {
+    allocation_tag tag() const noexcept { return tag_; }
+    void set_tag(allocation_tag tag) noexcept { tag_ = tag; }
+
+private:
+    allocation_tag tag_;
+};
+
+// Замена RAII-замеров (latency::scope, timeline_trace::slice) и доставки
+// событий (allocator_observers::deferred_scope) при выключенной политике
+struct no_scope {
+    template <typename... Args>
+    explicit no_scope(Args&&...) noexcept {}
+};
+
+// Счетчики арены; без статистики - пустая база
+template <bool Enabled>
+struct arena_counters {};
+
+template <>
+struct arena_counters<true> {
+    // Аллокатор не потокобезопасен, поэтому обычные поля
+    std::size_t allocate_calls = 0;
+    std::size_t deallocate_calls = 0;
+    std::size_t live_slots = 0;
+    std::size_t high_water_slots = 0;
+};
+
+} // namespace my_allocator_detail
 
 // Шаблонный класс аллокатора с параметрами:
-template <typename T, std::size_t ChunkSize = 10>
-class my_allocator {
+// ChunkSize - базовый размер чанка в элементах, Policy - политики
+// (allocator_policies.h): многопоточность, статистика, средства
+// наблюдения, выравнивание, источник памяти и рост чанков
+template <typename T, std::size_t ChunkSize = 10, typename Policy = default_allocator_policy>
+class my_allocator
+    : private my_allocator_detail::tag_holder<MY_ALLOCATOR_TAGS && Policy::tracing> {
+    struct arena;
+    using tag_base = my_allocator_detail::tag_holder<MY_ALLOCATOR_TAGS && Policy::tracing>;
+
+    // Что из собранного в программу использует эта конфигурация
+    static constexpr bool statistics = MY_ALLOCATOR_STATS && Policy::statistics;
+    static constexpr bool tracing = Policy::tracing;
+    static constexpr bool snapshots = MY_ALLOCATOR_SNAPSHOT && Policy::tracing;
+    static constexpr std::size_t alignment = std::max(alignof(T), Policy::alignment);
+
+    // Блокировка арены: снимку кучи из другого потока нужен настоящий mutex
+    using mutex_type = std::conditional_t<snapshots, std::mutex, typename Policy::threading::mutex_type>;
+    using latency_scope = std::conditional_t<tracing, latency::scope, my_allocator_detail::no_scope>;
+    using timeline_slice = std::conditional_t<tracing, timeline_trace::slice, my_allocator_detail::no_scope>;
+    using observer_scope = std::conditional_t<tracing, allocator_observers::deferred_scope, my_allocator_detail::no_scope>;
+    using family_type = my_allocator_detail::arena_family<typename Policy::threading::mutex_type>;
+
 public:
     using value_type = T;
     using pointer = T*;
@@ -19,70 +148,177 @@ public:
     using const_reference = const T&;
     using size_type = std::size_t;  // Тип для размеров
     using difference_type = std::ptrdiff_t; // Тип для разницы указателей
-    
+    using policy_type = Policy;
+
+    // Копии разделяют арены, поэтому аллокатор переходит вместе с памятью
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    // Поддержка release(): учет по отдельным указателям (профили,
+    // трасса, теги) требует поштучного deallocate
+    static constexpr bool bulk_release =
+        !(tracing && (MY_ALLOCATOR_HEAP_PROFILE || MY_ALLOCATOR_LIFETIME || MY_ALLOCATOR_TRACE || MY_ALLOCATOR_TAGS));
+
     template <typename U>
     struct rebind {
-        using other = my_allocator<U, ChunkSize>;
+        using other = my_allocator<U, ChunkSize, Policy>;
     };
 
+    // Семейство арен создается лениво: при первом allocate или первом
+    // копировании, поэтому пустые контейнеры с аллокатором по умолчанию
+    // не выделяют памяти, а их конструкторы не бросают
+#if MY_ALLOCATOR_TAGS
+    // Конструктор по умолчанию; тег - место создания аллокатора.
+    // Контейнеры STL создают аллокатор в своих заголовках (stl_tree.h),
+    // и тег указал бы туда: им аллокатор передается явно, с
+    // allocation_tag::named
+    my_allocator(creation_site where = creation_site()) noexcept
+        : my_allocator(where.site) {}
+
+    // Тег - заданное место; my_container передает сюда место своего создания
+    explicit my_allocator(allocation_site site) noexcept {
+        if constexpr (tracing) set_tag(allocation_tag::at(site));
+    }
+#else
     // Конструктор по умолчанию
-    my_allocator() noexcept = default; 
-    
-    // Конструктор копирования для другого типа 
+    my_allocator() noexcept {}
+#endif
+
+    // Конструктор с явным тегом для учета потребления
+    explicit my_allocator(allocation_tag tag) noexcept {
+        set_tag(tag);
+    }
+
+    // Конструктор копирования для другого типа (rebind): семейство арен
+    // и тег общие с other. Арена типа T ищется при первом allocate или
+    // deallocate этой копии, поэтому сама копия не берет блокировок
     template <typename U>
-    my_allocator(const my_allocator<U, ChunkSize>&) noexcept {}  
-    
-    // Конструктор копирования
-    my_allocator(const my_allocator&) noexcept = default;  
-    
-    // Деструктор
-    ~my_allocator() {
-        for (auto& chunk : chunks_) {
-            for (size_type i = 0; i < chunk.used; ++i) {
-                chunk.data[i].~T();  // Вызов деструктора для каждого объекта
-            }
-            // Освобождаем сырую память чанка
-            operator delete(chunk.data);
-        }
-        // Вектор chunks автоматически уничтожится
+    my_allocator(const my_allocator<U, ChunkSize, Policy>& other) noexcept
+        : family_(other.share_family()) {
+        set_tag(other.tag());
+    }
+
+    // Копирование: копия разделяет арены и равна исходному аллокатору.
+    // Чанки освобождаются вместе с последней копией
+    my_allocator(const my_allocator& other) noexcept
+        : tag_base(other), family_(other.share_family()), arena_(other.arena_) {}
+
+    my_allocator& operator=(const my_allocator& other) noexcept {
+        family_ = other.share_family();
+        arena_ = other.arena_;
+        set_tag(other.tag());
+        return *this;
+    }
+
+    // Перемещение копирует семейство, если оно есть, но не создает его:
+    // перемещение пустого контейнера не выделяет памяти. Исходный
+    // аллокатор остается рабочим
+    my_allocator(my_allocator&& other) noexcept
+        : tag_base(other), family_(other.family_), arena_(other.arena_) {}
+
+    my_allocator& operator=(my_allocator&& other) noexcept {
+        family_ = other.family_;
+        arena_ = other.arena_;
+        set_tag(other.tag());
+        return *this;
     }
 
     // Основной метод выделения памяти
     pointer allocate(size_type n) {
+        return allocate(n, tag());
+    }
+
+    // Выделение с явным тегом; освобождать с тем же тегом
+    pointer allocate(size_type n, allocation_tag tag) {
+        if (n == 0) return nullptr;
+        arena& a = local();
+#if MY_ALLOCATOR_OBSERVER
+        // События медленного пути доставляются после снятия блокировки
+        observer_scope observers;
+#endif
+        std::lock_guard<mutex_type> lock(a.mutex);
+#if MY_ALLOCATOR_LATENCY
+        latency_scope timing(latency::operation::allocate);
+#endif
+
+        std::ptrdiff_t chunk_index = -1;  // Для точки трассировки; -1 - слот из списка свободных
+        // Одиночный слот сначала берется из списка освобожденных
+        pointer result = n == 1 && a.free_list ? a.pop_free_slot() : a.bump(n, chunk_index);
+
+        if constexpr (statistics) a.record_allocate(n);
+        if constexpr (tracing) {
+            count_call(n);
+            trace_allocate(a, result, n, chunk_index, tag);
+        } else {
+            (void)tag;
+            (void)chunk_index;
+        }
+        return result;
+    }
+
+    // Пачка из n смежных слотов, которые возвращаются по одному через
+    // deallocate(p, 1): так контейнеры выделяют узлы. Память берется
+    // одним вызовом, а статистика, трасса, профили и теги видят n
+    // выделений по слоту, чтобы каждое освобождение нашло свою пару
+    pointer allocate_batch(size_type n) {
         if (n == 0) return nullptr;
-        
-        // Поиск чанка с достаточным местом среди уже существующих
-        for (auto& chunk : chunks_) {
-            // Если в текущем чанке достаточно свободного места
-            if (chunk.size - chunk.used >= n) {
-                // Возвращаем указатель на начало свободной области
-                pointer result = chunk.data + chunk.used;
-                chunk.used += n;  // Увеличиваем счетчик использованных элементов
-                return result;
-            }
-        }
-        
-        // Если подходящего чанка не найдено - создаем новый
-        size_type new_size = std::max(ChunkSize, n);
-        // Выделяем сырую память для чанка
-        pointer new_memory = static_cast<pointer>(operator new(new_size * sizeof(T)));
-        if (!new_memory) {
-            throw std::bad_alloc();
-        }
-        
-        // Добавляем новый чанк в вектор
-        chunks_.push_back({new_memory, new_size, 0});
-        pointer result = chunks_.back().data;
-        chunks_.back().used = n;  // Помечаем память как использованную
+        allocation_tag tag = this->tag();
+        arena& a = local();
+#if MY_ALLOCATOR_OBSERVER
+        // События медленного пути доставляются после снятия блокировки
+        observer_scope observers;
+#endif
+        std::lock_guard<mutex_type> lock(a.mutex);
+#if MY_ALLOCATOR_LATENCY
+        latency_scope timing(latency::operation::allocate);
+#endif
+
+        std::ptrdiff_t chunk_index = -1;
+        pointer result = a.bump(n, chunk_index);
+
+        if constexpr (statistics) a.record_allocate(n, n);
+        if constexpr (tracing) {
+            // Для allocation_guard пачка - один вызов аллокатора
+            count_call(n);
+            for (size_type i = 0; i < n; ++i) trace_allocate(a, result + i, 1, chunk_index, tag);
+        } else {
+            (void)tag;
+            (void)chunk_index;
+        }
         return result;
     }
 
-    // Метод освобождения памяти
+    // Метод освобождения памяти: одиночные слоты уходят в список
+    // для повторного использования, блоки из нескольких элементов
+    // остаются в чанке до разрушения арены
     void deallocate(pointer p, size_type n) noexcept {
-        (void)p;
-        (void)n;
+        deallocate(p, n, tag());
+    }
+
+    // Освобождение nullptr ничего не делает. Если у этой копии нет арены
+    // типа T (p выделен не этим семейством) - тоже ничего
+    void deallocate(pointer p, size_type n, allocation_tag tag) noexcept {
+        if (!p) return;
+        arena* owner = arena_ ? arena_ : attach_existing();
+        if (!owner) return;
+        arena& a = *owner;
+        std::lock_guard<mutex_type> lock(a.mutex);
+#if MY_ALLOCATOR_LATENCY
+        latency_scope timing(latency::operation::deallocate);
+#endif
+        if constexpr (tracing) {
+            trace_deallocate(a, p, n, tag);
+        } else {
+            (void)tag;
+        }
+        if (n == 1) {
+            a.push_free_slot(p);
+        }
+        if constexpr (statistics) a.record_deallocate(n);
     }
-    
+
     // Метод для конструирования объекта в выделенной памяти
     template <typename U, typename... Args>
     void construct(U* p, Args&&... args) {
@@ -100,26 +336,484 @@ public:
         return std::numeric_limits<size_type>::max() / sizeof(T);
     }
 
-    // Операторы сравнения аллокаторов
+    // Операторы сравнения аллокаторов: равны копии с общим семейством арен.
+    // Без семейства аллокатор еще не копировался и равен только себе
 
-    bool operator==(const my_allocator& other) const noexcept {  
-        return this == &other;  // Сравнение по идентичности объектов
+    template <typename U>
+    bool operator==(const my_allocator<U, ChunkSize, Policy>& other) const noexcept {
+        if (family_ || other.family_) return family_ == other.family_;
+        return static_cast<const void*>(this) == static_cast<const void*>(&other);
     }
 
-    bool operator!=(const my_allocator& other) const noexcept {  
+    template <typename U>
+    bool operator!=(const my_allocator<U, ChunkSize, Policy>& other) const noexcept {
         return !(*this == other);  // Противоположное равенству
     }
 
+    // Тег экземпляра: им помечаются allocate/deallocate без явного тега.
+    // Без учета по тегам (макрос или политика) - всегда пустой
+    allocation_tag tag() const noexcept {
+        return tag_base::tag();
+    }
+
+    void set_tag(allocation_tag tag) noexcept {
+        tag_base::set_tag(tag);
+    }
+
+    // Снимок статистики арены типа T (общей для всех копий): счетчики
+    // ведутся на горячем пути, все производное от чанков считается здесь
+    allocator_stats stats() const noexcept {
+        allocator_stats result;
+        if (!family_) return result;
+        const arena* a = arena_ ? arena_ : family_->template find<arena>();
+        if (!a) return result;
+        std::lock_guard<mutex_type> lock(a->mutex);
+        if constexpr (statistics) {
+            result.allocate_calls = a->allocate_calls;
+            result.deallocate_calls = a->deallocate_calls;
+            result.live_slots = a->live_slots;
+            result.live_bytes = a->live_slots * sizeof(T);
+            result.high_water_bytes = a->high_water_slots * sizeof(T);
+        }
+        result.chunk_count = a->chunks.size();
+        for (size_type i = 0; i < a->chunks.size(); ++i) {
+            const Chunk& chunk = a->chunks[i];
+            result.reserved_bytes += chunk.size * sizeof(T);
+            result.used_bytes += chunk.used * sizeof(T);
+            // Последний чанк еще заполняется, его хвост не считается потерянным
+            if (i + 1 < a->chunks.size()) {
+                result.wasted_tail_bytes += (chunk.size - chunk.used) * sizeof(T);
+            }
+        }
+        for (const void* slot = a->free_list; slot; std::memcpy(&slot, slot, sizeof(void*))) {
+            result.free_bytes += sizeof(T);
+        }
+        return result;
+    }
+
+    // Массовое освобождение (trim): все чанки арены типа T возвращаются
+    // источнику памяти за O(чанков), без deallocate по слотам; объекты
+    // в них должны быть уже разрушены или тривиальны. Выполняется, только
+    // если других копий аллокатора (любого типа) нет; иначе false
+    bool release() noexcept {
+        if constexpr (!bulk_release) {
+            return false;
+        } else {
+            if (!family_) return true;  // Ничего не выделялось
+            if (family_.use_count() != 1) return false;
+            arena* a = arena_ ? arena_ : family_->template find<arena>();
+            if (a) a->trim();
+            return true;
+        }
+    }
+
 private:
+    template <typename U, std::size_t, typename>
+    friend class my_allocator;
+
+    // Арена типа T в семействе; создается при первом allocate
+    arena& local() {
+        return arena_ ? *arena_ : attach();
+    }
+
+    MY_ALLOCATOR_COLD arena& attach() {
+        if (!family_) family_ = std::make_shared<family_type>();
+        arena_ = &family_->template get<arena>();
+        return *arena_;
+    }
+
+    // Семейство для новой копии; у еще не использованного аллокатора
+    // создается здесь, и other остается равным копии. Копирование
+    // аллокатора не бросает, поэтому нехватка памяти здесь - std::terminate.
+    // Запись атомарна: один свежий аллокатор можно копировать из разных потоков
+    std::shared_ptr<family_type> share_family() const noexcept {
+        auto current = std::atomic_load(&family_);
+        if (!current) {
+            auto created = std::make_shared<family_type>();
+            current = std::atomic_compare_exchange_strong(&family_, &current, created) ? created : current;
+        }
+        return current;
+    }
+
+    // Арена для deallocate через копию, которая сама еще не выделяла:
+    // если p выделен равной копией, арена типа T в семействе уже есть.
+    // nullptr - семейства или арены нет
+    MY_ALLOCATOR_COLD arena* attach_existing() noexcept {
+        if (family_) arena_ = family_->template find<arena>();
+        return arena_;
+    }
+
+    // Средства наблюдения после выделения и перед освобождением;
+    // вызываются только при Policy::tracing
+    static void count_call(size_type n) noexcept {
+#if MY_ALLOCATOR_GUARD
+        allocation_guard_detail::count_allocator(n * sizeof(T));
+#else
+        (void)n;
+#endif
+    }
+
+    static void trace_allocate(arena& a, pointer p, size_type n, std::ptrdiff_t chunk_index,
+                               allocation_tag tag) noexcept {
+        ALLOCATOR_PROBE4(allocate, &a, p, n * sizeof(T), chunk_index);
+#if MY_ALLOCATOR_TAGS
+        allocation_tags::record_allocate(tag, n * sizeof(T));
+#else
+        (void)tag;
+#endif
+#if MY_ALLOCATOR_LIFETIME
+        lifetime_profiler::record_allocate(tag, p, n * sizeof(T));
+#endif
+#if MY_ALLOCATOR_TRACE
+        allocation_trace::record_allocate(p, n * sizeof(T));
+#endif
+#if MY_ALLOCATOR_HEAP_PROFILE
+        heap_profiler::record_allocate(p, n * sizeof(T));
+#endif
+#if MY_ALLOCATOR_TIMELINE
+        timeline_trace::record_allocate(n * sizeof(T));
+#endif
+        (void)a;
+        (void)p;
+        (void)chunk_index;
+    }
+
+    static void trace_deallocate(arena& a, pointer p, size_type n, allocation_tag tag) noexcept {
+        ALLOCATOR_PROBE3(deallocate, &a, p, n * sizeof(T));
+#if MY_ALLOCATOR_HEAP_PROFILE
+        heap_profiler::record_deallocate(p);
+#endif
+#if MY_ALLOCATOR_LIFETIME
+        lifetime_profiler::record_deallocate(p);
+#endif
+#if MY_ALLOCATOR_TAGS
+        allocation_tags::record_deallocate(tag, n * sizeof(T));
+#else
+        (void)tag;
+#endif
+#if MY_ALLOCATOR_TRACE
+        allocation_trace::record_deallocate(p, n * sizeof(T));
+#endif
+#if MY_ALLOCATOR_TIMELINE
+        timeline_trace::record_deallocate(n * sizeof(T));
+#endif
+        (void)a;
+        (void)p;
+        (void)n;
+    }
+
     // Структура для представления блока памяти
     struct Chunk {
         pointer data;      // Указатель на начало памяти чанка
-        size_type size;    // Общий размер чанка 
+        size_type size;    // Общий размер чанка
         size_type used;    // Количество использованных элементов в чанке
     };
-    
-    // Вектор для хранения всех выделенных чанков
-    std::vector<Chunk> chunks_;
+
+    // Чанки и список свободных слотов одного типа элементов.
+    // Принадлежит семейству и разрушается вместе с последней копией аллокатора
+    struct arena : my_allocator_detail::arena_counters<statistics> {
+        arena() noexcept {
+#if MY_ALLOCATOR_SNAPSHOT
+            if constexpr (snapshots) heap_snapshot::register_arena(this, &describe);
+#endif
+        }
+
+        ~arena() {
+#if MY_ALLOCATOR_SNAPSHOT
+            if constexpr (snapshots) heap_snapshot::unregister_arena(this);
+#endif
+            release_chunks();
+        }
+
+        arena(const arena&) = delete;
+        arena& operator=(const arena&) = delete;
+
+        // Освобождение всех чанков. Объекты разрушает владелец (контейнер) до
+        // deallocate; в чанках могут лежать и освобожденные слоты, поэтому
+        // деструкторы здесь не вызываются
+        void release_chunks() noexcept {
+            // Чанки забираются под блокировкой, а освобождаются и попадают
+            // к наблюдателям уже без нее
+            std::vector<Chunk> released;
+            {
+                std::lock_guard<mutex_type> lock(mutex);
+                released.swap(chunks);
+                free_list = nullptr;
+                first_open = 0;
+            }
+#if MY_ALLOCATOR_TIMELINE
+            timeline_slice timing("release_arena", static_cast<std::int64_t>(released.size()));
+            if constexpr (tracing) timeline_trace::record_chunks(-static_cast<std::int64_t>(released.size()));
+#endif
+            for (size_type i = 0; i < released.size(); ++i) {
+                Chunk& chunk = released[i];
+                if constexpr (tracing) {
+                    ALLOCATOR_PROBE4(chunk_release, this, i, chunk.data, chunk.size * sizeof(T));
+                }
+                // Освобождаем сырую память чанка
+                Policy::chunk_source::release(chunk.data, chunk.size * sizeof(T), alignment);
+#if MY_ALLOCATOR_OBSERVER
+                if constexpr (tracing) {
+                    allocator_observers::notify(&allocator_observer::on_chunk_release,
+                                                observer_event(chunk.data, chunk.size * sizeof(T), released.size() - i - 1));
+                }
+#endif
+#if MY_ALLOCATOR_STATS
+                if constexpr (statistics) {
+                    auto& global = allocator_stats_detail::local();
+                    allocator_stats_detail::bump(global.chunks_released, 1);
+                    allocator_stats_detail::bump(global.chunk_bytes_released, chunk.size * sizeof(T));
+                }
+#endif
+            }
+        }
+
+        // release(): живые слоты списываются одним освобождением, затем
+        // освобождаются чанки. Вызывающий - единственный владелец арены
+        void trim() noexcept {
+            if (chunks.empty()) return;
+            size_type chunk_bytes = 0;
+            for (const Chunk& chunk : chunks) chunk_bytes += chunk.size * sizeof(T);
+#if MY_ALLOCATOR_TIMELINE
+            timeline_slice timing("trim", static_cast<std::int64_t>(chunk_bytes));
+            if constexpr (tracing) {
+                size_type live = 0;
+                for (const Chunk& chunk : chunks) live += chunk.used;
+                for (const void* slot = free_list; slot; std::memcpy(&slot, slot, sizeof(void*))) --live;
+                timeline_trace::record_deallocate(live * sizeof(T));
+            }
+#endif
+            if constexpr (tracing) {
+                ALLOCATOR_PROBE3(trim, this, chunks.size(), chunk_bytes);
+            }
+#if MY_ALLOCATOR_OBSERVER
+            if constexpr (tracing) {
+                allocator_observers::notify(&allocator_observer::on_trim, observer_event(nullptr, chunk_bytes, 0));
+            }
+#endif
+            if constexpr (statistics) {
+                if (this->live_slots) record_deallocate(this->live_slots);
+            }
+            release_chunks();
+        }
+
+        // Выделение n элементов из хвоста первого подходящего чанка
+        // или из нового; chunk_index - номер чанка
+        pointer bump(size_type n, std::ptrdiff_t& chunk_index) {
+            pointer result = nullptr;
+            // Поиск чанка с достаточным местом среди уже существующих;
+            // заполненные до конца чанки в начале списка пропускаются
+            for (size_type i = first_open; i < chunks.size(); ++i) {
+                Chunk& chunk = chunks[i];
+                // Если в текущем чанке достаточно свободного места
+                if (chunk.size - chunk.used >= n) {
+                    // Возвращаем указатель на начало свободной области
+                    result = chunk.data + chunk.used;
+                    chunk.used += n;  // Увеличиваем счетчик использованных элементов
+                    chunk_index = static_cast<std::ptrdiff_t>(i);
+                    break;
+                }
+            }
+
+            // Если подходящего чанка не найдено - создаем новый
+            if (!result) {
+                result = allocate_chunk(n);
+                chunk_index = static_cast<std::ptrdiff_t>(chunks.size()) - 1;
+            }
+            skip_full_chunks();
+            return result;
+        }
+
+        // Продвижение first_open за чанки без свободного хвоста
+        void skip_full_chunks() noexcept {
+            while (first_open < chunks.size() && chunks[first_open].used == chunks[first_open].size) {
+                ++first_open;
+            }
+        }
+
+        // Список свободных слотов хранит указатель на следующий прямо в слоте,
+        // поэтому работает только для типов не меньше указателя
+        static constexpr bool recycles_slots = sizeof(T) >= sizeof(void*);
+
+        void push_free_slot(pointer p) noexcept {
+            if constexpr (recycles_slots) {
+                std::memcpy(static_cast<void*>(p), &free_list, sizeof(void*));
+                free_list = p;
+            } else {
+                (void)p;
+            }
+        }
+
+        pointer pop_free_slot() noexcept {
+            void* slot = free_list;
+            std::memcpy(&free_list, slot, sizeof(void*));
+            return static_cast<pointer>(slot);
+        }
+
+        // Медленный путь: новый чанк под запрос из n элементов
+        MY_ALLOCATOR_COLD pointer allocate_chunk(size_type n) {
+            size_type new_size = std::max(Policy::growth::next_chunk(ChunkSize, chunks.size()), n);
+#if MY_ALLOCATOR_TIMELINE
+            timeline_slice timing("allocate_chunk", static_cast<std::int64_t>(new_size * sizeof(T)));
+#endif
+#if MY_ALLOCATOR_OBSERVER
+            if constexpr (tracing) {
+                allocator_observers::defer(&allocator_observer::on_slow_path,
+                                           observer_event(nullptr, n * sizeof(T)));
+            }
+#endif
+            // Выделяем сырую память для чанка
+            pointer new_memory = nullptr;
+            try {
+                new_memory = static_cast<pointer>(Policy::chunk_source::allocate(new_size * sizeof(T), alignment));
+                // Добавляем новый чанк в вектор
+                chunks.push_back({new_memory, new_size, 0});
+            } catch (const std::bad_alloc&) {
+                if (new_memory) Policy::chunk_source::release(new_memory, new_size * sizeof(T), alignment);
+#if MY_ALLOCATOR_OBSERVER
+                if constexpr (tracing) {
+                    allocator_observers::defer(&allocator_observer::on_oom,
+                                               observer_event(nullptr, new_size * sizeof(T)));
+                }
+#endif
+                throw;
+            }
+            pointer result = chunks.back().data;
+            chunks.back().used = n;  // Помечаем память как использованную
+            if constexpr (tracing) {
+                ALLOCATOR_PROBE4(chunk_acquire, this, chunks.size() - 1, new_memory, new_size * sizeof(T));
+#if MY_ALLOCATOR_TIMELINE
+                timeline_trace::record_chunks(1);
+#endif
+#if MY_ALLOCATOR_OBSERVER
+                allocator_observers::defer(&allocator_observer::on_chunk_acquire,
+                                           observer_event(new_memory, new_size * sizeof(T)));
+#endif
+            }
+#if MY_ALLOCATOR_STATS
+            if constexpr (statistics) {
+                auto& global = allocator_stats_detail::local();
+                allocator_stats_detail::bump(global.chunks_acquired, 1);
+                allocator_stats_detail::bump(global.chunk_bytes_acquired, new_size * sizeof(T));
+            }
+#endif
+            return result;
+        }
+
+#if MY_ALLOCATOR_OBSERVER
+        allocator_event observer_event(const void* address, size_type bytes) const noexcept {
+            return observer_event(address, bytes, chunks.size());
+        }
+
+        allocator_event observer_event(const void* address, size_type bytes, size_type count) const noexcept {
+            allocator_event event;
+            event.arena = this;
+            event.slot_size = sizeof(T);
+            event.address = address;
+            event.bytes = bytes;
+            event.chunks = count;
+            return event;
+        }
+#endif
+
+#if MY_ALLOCATOR_STATS
+        // calls - сколько выделений засчитать (пачка - по одному на слот)
+        void record_allocate(size_type n, size_type calls = 1) noexcept {
+            this->allocate_calls += calls;
+            this->live_slots += n;
+            if (this->live_slots > this->high_water_slots) {
+                this->high_water_slots = this->live_slots;
+            }
+            auto& global = allocator_stats_detail::local();
+            allocator_stats_detail::bump(global.allocate_calls, calls);
+            allocator_stats_detail::bump(global.allocated_bytes, n * sizeof(T));
+        }
+
+        void record_deallocate(size_type n) noexcept {
+            ++this->deallocate_calls;
+            this->live_slots -= n;
+            auto& global = allocator_stats_detail::local();
+            allocator_stats_detail::bump(global.deallocate_calls, 1);
+            allocator_stats_detail::bump(global.deallocated_bytes, n * sizeof(T));
+        }
+#endif
+
+#if MY_ALLOCATOR_SNAPSHOT
+        // Отчет арены для снимка кучи: все под границей заполнения чанка
+        // считается живым, кроме слотов из списка освобожденных
+        static void describe(const void* address, heap_snapshot::arena_report& out) {
+            const arena& self = *static_cast<const arena*>(address);
+            std::lock_guard<mutex_type> lock(self.mutex);
+            out.type = typeid(T).name();
+            out.slot_size = sizeof(T);
+
+            std::vector<std::vector<std::uint8_t>> maps(self.chunks.size());
+            for (size_type i = 0; i < self.chunks.size(); ++i) {
+                const Chunk& chunk = self.chunks[i];
+                maps[i].assign(chunk.size, heap_snapshot::slot_unused);
+                std::fill(maps[i].begin(), maps[i].begin() + chunk.used, heap_snapshot::slot_live);
+            }
+
+            // Чанки по адресу - для поиска владельца освобожденного слота
+            std::vector<size_type> order(self.chunks.size());
+            for (size_type i = 0; i < order.size(); ++i) order[i] = i;
+            std::less<const T*> before;
+            std::sort(order.begin(), order.end(), [&](size_type x, size_type y) {
+                return before(self.chunks[x].data, self.chunks[y].data);
+            });
+            for (const void* slot = self.free_list; slot; std::memcpy(&slot, slot, sizeof(void*))) {
+                const T* p = static_cast<const T*>(slot);
+                auto it = std::upper_bound(order.begin(), order.end(), p, [&](const T* value, size_type index) {
+                    return before(value, self.chunks[index].data);
+                });
+                if (it == order.begin()) continue;
+                const Chunk& chunk = self.chunks[*(it - 1)];
+                if (!before(p, chunk.data + chunk.size)) continue;
+                maps[*(it - 1)][static_cast<size_type>(p - chunk.data)] = heap_snapshot::slot_free;
+            }
+
+            for (size_type i = 0; i < self.chunks.size(); ++i) {
+                const Chunk& chunk = self.chunks[i];
+                heap_snapshot::chunk_report report;
+                report.address = chunk.data;
+                report.slots = chunk.size;
+                report.used = chunk.used;
+                report.live = static_cast<std::size_t>(std::count(maps[i].begin(), maps[i].end(),
+                                                                  heap_snapshot::slot_live));
+                report.occupancy = heap_snapshot::summarize(maps[i]);
+                out.chunks.push_back(std::move(report));
+            }
+        }
+#endif
+
+        // Вектор для хранения всех выделенных чанков
+        std::vector<Chunk> chunks;
+
+        // Голова списка освобожденных одиночных слотов
+        void* free_list = nullptr;
+
+        // Все чанки до этого номера заполнены до конца
+        size_type first_open = 0;
+
+        // Защищает арену от других потоков (политика threading) и от
+        // снимка кучи; у single_threaded без снимков - пустой null_mutex
+        mutable mutex_type mutex;
+    };
+
+    // Общие для копий арены (nullptr до первого allocate или копирования)
+    // и арена типа T в них (nullptr до первого обращения)
+    mutable std::shared_ptr<family_type> family_;
+    arena* arena_ = nullptr;
 };
 
-#endif
\ No newline at end of file
+// Выключенные политики не оставляют данных: у minimal_allocator_policy
+// экземпляр - только указатели на семейство и арену, арена без счетчиков
+static_assert(std::is_empty<my_allocator_detail::tag_holder<false>>::value &&
+              std::is_empty<my_allocator_detail::arena_counters<false>>::value &&
+              std::is_empty<null_mutex>::value,
+              "выключенная политика не должна занимать место");
+static_assert(sizeof(my_allocator<void*, 16, minimal_allocator_policy>) ==
+              sizeof(std::shared_ptr<my_allocator_detail::arena_family<null_mutex>>) + sizeof(void*),
+              "у minimal_allocator_policy не должно быть полей сверх указателей на арену");
+
+#endif
@@ -1,34 +1,158 @@
 #ifndef MY_CONTAINER_H
 #define MY_CONTAINER_H
 
+#include <cstddef>
+#include <cstring>
+#include <functional>
 #include <memory>
 #include <iterator>
 #include <initializer_list>
 #include <type_traits>
+#include <utility>
+#include "allocation_tags.h"
+#include "allocator_probes.h"
+#include "latency_histogram.h"
 
-// Шаблонный класс контейнера
-template <typename T, typename Allocator = std::allocator<T>>
+namespace my_container_detail {
+
+// Узел списка: один элемент и указатель на следующий
+template <typename T>
+struct list_node {
+    T data;           // Данные узла
+    list_node* next;  // Указатель на следующий узел
+
+    //Шаблонный констурктор позволяет конструировать данные с любым количеством аргументов
+    template <typename... Args>
+    list_node(Args&&... args)
+        : data(std::forward<Args>(args)...),  // Передача аргументов конструктору T
+          next(nullptr) {}                    // Следующий узел инициализируется nullptr
+};
+
+// Узел развернутого списка: до Capacity элементов подряд. Элементы
+// конструирует и разрушает контейнер, узел только хранит память под них
+template <typename T, std::size_t Capacity>
+struct unrolled_node {
+    unrolled_node* next = nullptr;
+    std::size_t count = 0;  // Занято первых count элементов
+    union {
+        T items[Capacity];
+    };
+
+    unrolled_node() noexcept {}
+    ~unrolled_node() {}
+};
+
+// Аллокатор позволяет выделить узлы пачкой и вернуть их по одному
+// (my_allocator::allocate_batch). Для std::allocator нет
+template <typename Alloc, typename = void>
+struct splittable_batches : std::false_type {};
+
+template <typename Alloc>
+struct splittable_batches<Alloc, std::void_t<decltype(std::declval<Alloc&>().allocate_batch(std::size_t()))>>
+    : std::true_type {};
+
+// Аллокатор по умолчанию с тегом места вызова, если аллокатор его
+// принимает (my_allocator при MY_ALLOCATOR_TAGS)
+template <typename Alloc>
+Alloc allocator_at(const allocation_site& site) {
+    if constexpr (std::is_constructible_v<Alloc, allocation_site>) {
+        return Alloc(site);
+    } else {
+        (void)site;
+        return Alloc();
+    }
+}
+
+// Аллокатор умеет освобождать все выделенное разом (my_allocator::release)
+template <typename Alloc, typename = void>
+struct bulk_release : std::false_type {};
+
+template <typename Alloc>
+struct bulk_release<Alloc, std::void_t<decltype(Alloc::bulk_release)>>
+    : std::bool_constant<Alloc::bulk_release> {};
+
+template <typename It>
+using require_input_iterator = std::enable_if_t<std::is_base_of_v<std::input_iterator_tag,
+    typename std::iterator_traits<It>::iterator_category>>;
+
+} // namespace my_container_detail
+
+// Число элементов в узле развернутого списка, при котором узел
+// занимает CacheLines строк кэша по 64 байта (но не меньше одного).
+// Строки выравниваются по кэшу, если чанки аллокатора выровнены по 64:
+// например, политика my_allocator с alignment = 64
+template <typename T, std::size_t CacheLines = 1>
+inline constexpr std::size_t unrolled_capacity =
+    CacheLines * 64 > 2 * sizeof(std::size_t) + sizeof(T)
+        ? (CacheLines * 64 - 2 * sizeof(std::size_t)) / sizeof(T)
+        : 1;
+
+// Шаблонный класс контейнера. NodeCapacity > 1 включает развернутый
+// список: узел хранит массив элементов, push_back сначала заполняет
+// хвостовой узел, обход идет по массиву и лишь затем по next
+template <typename T, typename Allocator = std::allocator<T>, std::size_t NodeCapacity = 1>
 class my_container {
+    static_assert(NodeCapacity > 0, "NodeCapacity must be positive");
+
+public:
+    static constexpr std::size_t node_capacity = NodeCapacity;
+
 private:
-    struct Node {
-        T data;      // Данные узла
-        Node* next;  // Указатель на следующий узел
-        
-        //Шаблонный констурктор позволяет конструировать данные с любым количеством аргументов
-        template <typename... Args>
-        Node(Args&&... args) 
-            : data(std::forward<Args>(args)...),  // Передача аргументов конструктору T
-              next(nullptr) {}                    // Следующий узел инициализируется nullptr
+    static constexpr bool unrolled = NodeCapacity > 1;
+
+    using Node = std::conditional_t<unrolled,
+        my_container_detail::unrolled_node<T, NodeCapacity>,
+        my_container_detail::list_node<T>>;
+
+    // Позиция итератора: узел списка
+    template <typename NodePtr, typename Pointer, bool Unrolled = unrolled>
+    struct position {
+        NodePtr node;
+
+        explicit position(NodePtr n = nullptr) : node(n) {}
+        template <typename N, typename P>
+        position(const position<N, P, Unrolled>& other) : node(other.node) {}
+
+        Pointer get() const { return &node->data; }
+        void advance() { node = node->next; }
+        bool operator==(const position& other) const { return node == other.node; }
     };
-    
+
+    // Позиция в развернутом списке: узел и элемент в нем. Конец - nullptr
+    template <typename NodePtr, typename Pointer>
+    struct position<NodePtr, Pointer, true> {
+        NodePtr node;
+        Pointer item;
+
+        explicit position(NodePtr n = nullptr) : node(n), item(n ? n->items : nullptr) {}
+        template <typename N, typename P>
+        position(const position<N, P, true>& other) : node(other.node), item(other.item) {}
+
+        Pointer get() const { return item; }
+        void advance() {
+            if (++item == node->items + node->count) {
+                node = node->next;
+                item = node ? node->items : nullptr;
+            }
+        }
+        bool operator==(const position& other) const { return item == other.item; }
+    };
+
     using node_allocator_type = typename std::allocator_traits<Allocator>::
         template rebind_alloc<Node>;
     using node_traits = std::allocator_traits<node_allocator_type>;
+
+    // Узлы можно не обходить при очистке: деструкторы элементов ничего
+    // не делают, а память аллокатор возвращает целиком
+    static constexpr bool bulk_clear = std::is_trivially_destructible_v<T> &&
+        my_container_detail::bulk_release<node_allocator_type>::value;
     
     Node* head_;
     Node* tail_;
     size_t size_;               // Количество элементов в контейнере
     node_allocator_type allocator_;  // Аллокатор для выделения памяти под узлы
+    Node* spare_ = nullptr;     // Запас узлов (reserve): сырая память без объектов
+    size_t spare_count_ = 0;    // Количество узлов в запасе
 
 public:
     // Класс неконстантного итератора
@@ -45,14 +169,14 @@ public:
         iterator(Node* node = nullptr) : current_(node) {}
         
         // Оператор разыменования 
-        reference operator*() const { return current_->data; }
+        reference operator*() const { return *current_.get(); }
         
         // Оператор доступа к членам через указатель
-        pointer operator->() const { return &current_->data; }
+        pointer operator->() const { return current_.get(); }
         
         // Префиксный инкремент 
         iterator& operator++() {
-            current_ = current_->next;  // Переход к следующему узлу
+            current_.advance();  // Переход к следующему элементу
             return *this;
         }
         
@@ -73,7 +197,7 @@ public:
         }
         
     private:
-        Node* current_;  
+        position<Node*, T*> current_;
         friend class my_container;
     };
     
@@ -90,11 +214,11 @@ public:
         const_iterator(const Node* node = nullptr) : current_(node) {}
         const_iterator(const iterator& it) : current_(it.current_) {}
         
-        reference operator*() const { return current_->data; }
-        pointer operator->() const { return &current_->data; }
+        reference operator*() const { return *current_.get(); }
+        pointer operator->() const { return current_.get(); }
         
         const_iterator& operator++() {
-            current_ = current_->next;
+            current_.advance();
             return *this;
         }
         
@@ -113,11 +237,23 @@ public:
         }
         
     private:
-        const Node* current_;  // Константный указатель на узел
+        position<const Node*, const T*> current_;  // Константная позиция
     };
     
+#if MY_ALLOCATOR_TAGS
+    // Конструктор по умолчанию; тег аллокатора - место создания
+    // контейнера, а не эта строка заголовка
+    my_container(creation_site where = creation_site())
+        : my_container(where.site) {}
+
+    // Тег аллокатора - заданное место
+    explicit my_container(allocation_site site)
+        : head_(nullptr), tail_(nullptr), size_(0),
+          allocator_(my_container_detail::allocator_at<Allocator>(site)) {}
+#else
     // Конструктор по умолчанию
     my_container() : head_(nullptr), tail_(nullptr), size_(0) {}
+#endif
     
     // Конструктор с аллокатором
     explicit my_container(const Allocator& alloc) 
@@ -127,9 +263,20 @@ public:
     my_container(std::initializer_list<T> init, const Allocator& alloc = Allocator())
         : head_(nullptr), tail_(nullptr), size_(0), allocator_(alloc) {
         // Добавляем все элементы из initializer_list
-        for (const auto& item : init) {
-            push_back(item);
-        }
+        append(init.begin(), init.end());
+    }
+
+    // Конструктор из диапазона итераторов
+    template <typename InputIt, typename = my_container_detail::require_input_iterator<InputIt>>
+    my_container(InputIt first, InputIt last, const Allocator& alloc = Allocator())
+        : head_(nullptr), tail_(nullptr), size_(0), allocator_(alloc) {
+        append(first, last);
+    }
+
+    // Конструктор из count копий value
+    my_container(size_t count, const T& value, const Allocator& alloc = Allocator())
+        : head_(nullptr), tail_(nullptr), size_(0), allocator_(alloc) {
+        append(count, value);
     }
 
     // Конструктор копирования
@@ -137,31 +284,41 @@ public:
         : head_(nullptr), tail_(nullptr), size_(0), 
           // Копируем аллокатор с учетом политики копирования
           allocator_(node_traits::select_on_container_copy_construction(other.allocator_)) {
-        // Последовательно копируем все элементы из другого контейнера
-        for (const auto& item : other) {
-            push_back(item);
-        }
+        // Копируем все элементы другого контейнера, размер известен заранее
+        append_elements(range_source<const_iterator>{other.begin()}, other.size_);
     }
     
     // Конструктор перемещения
     my_container(my_container&& other) noexcept
         : head_(other.head_), tail_(other.tail_), 
-          size_(other.size_), allocator_(std::move(other.allocator_)) {
+          size_(other.size_), allocator_(std::move(other.allocator_)),
+          spare_(other.spare_), spare_count_(other.spare_count_) {
         // Обнуляем указатели в перемещаемом объекте
         other.head_ = other.tail_ = nullptr;
         other.size_ = 0;
+        other.spare_ = nullptr;
+        other.spare_count_ = 0;
     }
     
     // Оператор присваивания копированием
     my_container& operator=(const my_container& other) {
         // Проверка на самоприсваивание
         if (this != &other) {
-            clear();  // Освобождаем текущие ресурсы
-            allocator_ = other.allocator_;  // Копируем аллокатор
-            // Копируем элементы
-            for (const auto& item : other) {
-                push_back(item);
+            // Копия строится целиком до замены содержимого и сразу
+            // аллокатором, который останется у *this: узлы освобождаются
+            // тем же аллокатором, что их выделил. При исключении *this
+            // не меняется
+            my_container copy(other.allocator_);
+            copy.append_elements(range_source<const_iterator>{other.begin()}, other.size_);
+            // Запас reserve() переживает присваивание, если узлы
+            // взаимозаменяемы между аллокаторами
+            if (copy.allocator_ == allocator_) {
+                copy.spare_ = spare_;
+                copy.spare_count_ = spare_count_;
+                spare_ = nullptr;
+                spare_count_ = 0;
             }
+            *this = std::move(copy);
         }
         return *this;
     }
@@ -169,85 +326,196 @@ public:
     // Оператор присваивания перемещением
     my_container& operator=(my_container&& other) noexcept {
         if (this != &other) {
-            clear();  // Освобождаем текущие ресурсы
+            // Освобождаем текущие ресурсы; запас принадлежит текущему аллокатору
+            if (!release_all()) {
+                clear();
+                release_spare();
+            }
             // Перемещаем ресурсы из другого контейнера
             head_ = other.head_;
             tail_ = other.tail_;
             size_ = other.size_;
             allocator_ = std::move(other.allocator_);
+            spare_ = other.spare_;
+            spare_count_ = other.spare_count_;
             // Обнуляем указатели в перемещаемом объекте
             other.head_ = other.tail_ = nullptr;
             other.size_ = 0;
+            other.spare_ = nullptr;
+            other.spare_count_ = 0;
         }
         return *this;
     }
     
     ~my_container() {
-        clear(); 
+        if (!release_all()) {
+            clear(); 
+            release_spare();
+        }
     }
     
     // Добавление элемента в конец 
     void push_back(const T& value) {
-        // Выделяем память для нового узла
-        Node* new_node = node_traits::allocate(allocator_, 1);
-        try {
-            // Конструируем узел в выделенной памяти
-            node_traits::construct(allocator_, new_node, value);
-        } catch (...) {
-            // В случае исключения при конструировании освобождаем память
-            node_traits::deallocate(allocator_, new_node, 1);
-            throw;  // Пробрасываем исключение дальше
-        }
-        
-        // Добавляем узел в список
-        if (!head_) {
-            // Если список пуст - новый узел становится и головой и хвостом
-            head_ = tail_ = new_node;
-        } else {
-            // Иначе добавляем в конец
-            tail_->next = new_node;
-            tail_ = new_node;
-        }
-        ++size_;  // Увеличиваем счетчик элементов
+#if MY_ALLOCATOR_LATENCY
+        latency::scope timing(latency::operation::push_back);
+#endif
+        Node* node = append_element(value);
+        ALLOCATOR_PROBE3(push_back, this, node, size_);
     }
     
     // Добавление элемента в конец 
     template <typename... Args>
     void emplace_back(Args&&... args) {
-        Node* new_node = node_traits::allocate(allocator_, 1);
-        try {
-            // Конструируем узел, передавая аргументы напрямую конструктору T
-            node_traits::construct(allocator_, new_node, std::forward<Args>(args)...);
-        } catch (...) {
-            node_traits::deallocate(allocator_, new_node, 1);
-            throw;
+#if MY_ALLOCATOR_LATENCY
+        latency::scope timing(latency::operation::push_back);
+#endif
+        Node* node = append_element(std::forward<Args>(args)...);
+        ALLOCATOR_PROBE3(push_back, this, node, size_);
+    }
+    
+    // Добавление элементов [first, last) в конец. Все новые узлы
+    // выделяются одним вызовом allocate, если аллокатор это позволяет.
+    // Диапазон может указывать в сам контейнер (c.append(c.begin(), c.end())):
+    // добавляются только элементы, бывшие в нем до вызова.
+    // Строгая гарантия: при исключении контейнер не меняется
+    template <typename InputIt, typename = my_container_detail::require_input_iterator<InputIt>>
+    void append(InputIt first, InputIt last) {
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                                        typename std::iterator_traits<InputIt>::iterator_category>) {
+            append_elements(range_source<InputIt>{first}, static_cast<size_t>(std::distance(first, last)));
+        } else {
+            // Однопроходный диапазон: размер заранее неизвестен, поэтому
+            // элементы сначала собираются во временный контейнер
+            Allocator staged_allocator(allocator_);
+            my_container staged(staged_allocator);
+            for (; first != last; ++first) staged.emplace_back(*first);
+            append_elements(range_source<std::move_iterator<iterator>>{std::make_move_iterator(staged.begin())},
+                            staged.size_);
         }
-        
-        if (!head_) {
-            head_ = tail_ = new_node;
+    }
+
+    // Добавление count копий value в конец; гарантии те же
+    void append(size_t count, const T& value) {
+        append_elements(fill_source{value}, count);
+    }
+
+    // Запас узлов под n элементов: после reserve(n) вставки до size() == n
+    // не обращаются к аллокатору. Недостающие узлы выделяются одной
+    // пачкой, если аллокатор это позволяет. При исключении запас не меняется
+    void reserve(size_t n) {
+        size_t have = capacity();
+        if (n <= have) return;
+        size_t nodes = (n - have + NodeCapacity - 1) / NodeCapacity;
+
+        if constexpr (my_container_detail::splittable_batches<node_allocator_type>::value) {
+            Node* batch = allocator_.allocate_batch(nodes);
+            for (size_t i = nodes; i-- > 0;) push_spare(batch + i);
         } else {
-            tail_->next = new_node;
-            tail_ = new_node;
+            // Выделенные до исключения узлы освобождаются
+            Node* chain = nullptr;
+            size_t count = 0;
+            try {
+                for (; count < nodes; ++count) {
+                    Node* node = node_traits::allocate(allocator_, 1);
+                    std::memcpy(static_cast<void*>(node), &chain, sizeof(Node*));
+                    chain = node;
+                }
+            } catch (...) {
+                while (chain) {
+                    Node* next;
+                    std::memcpy(&next, static_cast<void*>(chain), sizeof(Node*));
+                    node_traits::deallocate(allocator_, chain, 1);
+                    chain = next;
+                }
+                throw;
+            }
+            while (chain) {
+                Node* next;
+                std::memcpy(&next, static_cast<void*>(chain), sizeof(Node*));
+                push_spare(chain);
+                chain = next;
+            }
         }
-        ++size_;
     }
-    
-    // Очистка контейнера
-    void clear() noexcept {
+
+    // Число элементов, которое поместится без обращения к аллокатору
+    size_t capacity() const noexcept {
+        size_t tail_spare = 0;
+        if constexpr (unrolled) {
+            if (tail_) tail_spare = NodeCapacity - tail_->count;
+        }
+        return size_ + tail_spare + spare_count_ * NodeCapacity;
+    }
+
+    // Очистка контейнера; запас узлов сохраняется. keep_capacity = true:
+    // узлы не освобождаются, а уходят в запас в прежнем порядке, и
+    // следующее заполнение до прежнего размера не обращается к аллокатору.
+    // Удаления отдельных элементов (erase) в контейнере нет.
+    // Для тривиально разрушаемых T без запаса узлов и с единственной
+    // копией my_allocator - O(чанков) через release() аллокатора
+    void clear(bool keep_capacity = false) noexcept {
+#if MY_ALLOCATOR_LATENCY
+        latency::scope timing(latency::operation::clear);
+#endif
+        ALLOCATOR_PROBE2(clear, this, size_);
+        if (!keep_capacity && !spare_ && head_ && release_all()) return;
+        if (keep_capacity) {
+            Node* first = head_;
+            size_t nodes = 0;
+            while (head_) {
+                Node* next = head_->next;
+                destroy_node(head_);
+                // Последний узел цепочки ссылается на прежний запас
+                Node* link = next ? next : spare_;
+                std::memcpy(static_cast<void*>(head_), &link, sizeof(Node*));
+                ++nodes;
+                head_ = next;
+            }
+            if (first) {
+                spare_ = first;
+                spare_count_ += nodes;
+            }
+        }
         while (head_) {
             Node* next = head_->next;        // Сохраняем указатель на следующий узел
-            node_traits::destroy(allocator_, head_);  // Вызываем деструктор узла
+            destroy_node(head_);             // Разрушаем элементы и узел
             node_traits::deallocate(allocator_, head_, 1);  // Освобождаем память
             head_ = next;                     // Переходим к следующему узлу
         }
         head_ = tail_ = nullptr;
         size_ = 0;
     }
+
+    // Возврат запаса узлов (reserve, clear(true)) аллокатору
+    void shrink_to_fit() noexcept {
+        release_spare();
+    }
     
     // Получение количества элементов
     size_t size() const noexcept { return size_; }
     bool empty() const noexcept { return size_ == 0; }
 
+    // Расход памяти контейнером
+    struct memory_usage_info {
+        size_t elements;          // Количество элементов
+        size_t node_size;         // Размер одного узла в байтах
+        size_t payload_bytes;     // Полезные данные: elements * sizeof(T)
+        size_t node_bytes;        // Все узлы: nodes * sizeof(Node)
+        size_t overhead_per_element;  // (sizeof(Node) - NodeCapacity * sizeof(T)) / NodeCapacity:
+                                      // next, счетчик и выравнивание на элемент полного узла
+        size_t nodes;             // Количество узлов
+        size_t elements_per_node; // NodeCapacity
+        size_t spare_nodes;       // Узлы в запасе (не входят в node_bytes)
+    };
+
+    memory_usage_info memory_usage() const noexcept {
+        // Неполным бывает только хвостовой узел
+        size_t nodes = (size_ + NodeCapacity - 1) / NodeCapacity;
+        return {size_, sizeof(Node), size_ * sizeof(T), nodes * sizeof(Node),
+                (sizeof(Node) - NodeCapacity * sizeof(T)) / NodeCapacity,
+                nodes, NodeCapacity, spare_count_};
+    }
+
     // Неконстантные итераторы
     iterator begin() noexcept { return iterator(head_); }
     iterator end() noexcept { return iterator(nullptr); }  
@@ -259,6 +527,248 @@ public:
     // Явно константные итераторы (можно вызывать у неконстантных объектов)
     const_iterator cbegin() const noexcept { return const_iterator(head_); }
     const_iterator cend() const noexcept { return const_iterator(nullptr); }
+
+private:
+    // Источники элементов для append_elements
+    template <typename InputIt>
+    struct range_source {
+        InputIt first;
+
+        template <typename P>
+        void construct(node_allocator_type& alloc, P* p) { node_traits::construct(alloc, p, *first); }
+        void advance() { ++first; }
+    };
+
+    struct fill_source {
+        const T& value;
+
+        template <typename P>
+        void construct(node_allocator_type& alloc, P* p) { node_traits::construct(alloc, p, value); }
+        void advance() noexcept {}
+    };
+
+    // Добавление count элементов источника в конец. Новые узлы собираются
+    // в отдельную цепочку и присоединяются к списку после успеха;
+    // в развернутом режиме сначала заполняется хвостовой узел. Цикл
+    // ограничен count, а не концом источника: источник, читающий сам
+    // контейнер, не доходит до элементов, добавленных этим же вызовом.
+    // Все узлы выделяются одной пачкой (при splittable_batches)
+    template <typename Source>
+    void append_elements(Source source, size_t count) {
+        Node* head = nullptr;     // Цепочка новых узлов
+        Node* tail = nullptr;
+        Node* batch = nullptr;    // Узлы одной пачки
+        size_t batch_size = 0;
+        size_t batch_used = 0;
+        size_t from_spare = 0;    // Узлы цепочки из запаса; они идут первыми
+        size_t added = 0;
+        size_t tail_count = 0;    // Занято в tail_ до начала (развернутый режим)
+        if constexpr (unrolled) {
+            if (tail_) tail_count = tail_->count;
+        }
+
+        try {
+            if constexpr (my_container_detail::splittable_batches<node_allocator_type>::value) {
+                size_t spare = unrolled && tail_ ? NodeCapacity - tail_count : 0;
+                size_t nodes = count > spare ? (count - spare + NodeCapacity - 1) / NodeCapacity : 0;
+                nodes = nodes > spare_count_ ? nodes - spare_count_ : 0;
+                if (nodes > 1) {
+                    batch = allocator_.allocate_batch(nodes);
+                    batch_size = nodes;
+                }
+            }
+
+            for (size_t i = 0; i < count; ++i, source.advance()) {
+                if constexpr (unrolled) {
+                    // Свободное место в последнем узле
+                    Node* last = tail ? tail : tail_;
+                    if (last && last->count < NodeCapacity) {
+                        source.construct(allocator_, last->items + last->count);
+                        ++last->count;
+                        ++added;
+                        continue;
+                    }
+                }
+
+                // Узел: из запаса, из пачки или отдельным allocate
+                bool cached = spare_ != nullptr;
+                bool from_batch = !cached && batch_used < batch_size;
+                Node* node = cached ? pop_spare()
+                           : from_batch ? batch + batch_used++
+                           : node_traits::allocate(allocator_, 1);
+                try {
+                    if constexpr (unrolled) {
+                        node_traits::construct(allocator_, node);
+                        try {
+                            source.construct(allocator_, node->items);
+                        } catch (...) {
+                            node_traits::destroy(allocator_, node);
+                            throw;
+                        }
+                        node->count = 1;
+                    } else {
+                        source.construct(allocator_, node);
+                    }
+                } catch (...) {
+                    // Слот пачки освобождается вместе с пачкой
+                    if (cached) {
+                        push_spare(node);
+                    } else if (!from_batch) {
+                        node_traits::deallocate(allocator_, node, 1);
+                    }
+                    throw;
+                }
+
+                if (!head) {
+                    head = tail = node;
+                } else {
+                    tail->next = node;
+                    tail = node;
+                }
+                if (cached) ++from_spare;
+                ++added;
+            }
+        } catch (...) {
+            // Откат: разрушаем все новое, хвостовой узел возвращаем в исходное состояние
+            if constexpr (unrolled) {
+                if (tail_) {
+                    for (size_t i = tail_count; i < tail_->count; ++i) {
+                        node_traits::destroy(allocator_, tail_->items + i);
+                    }
+                    tail_->count = tail_count;
+                }
+            }
+            for (size_t i = 0; head; ++i) {
+                Node* next = head->next;
+                std::less<Node*> before;
+                bool in_batch = batch && !before(head, batch) && before(head, batch + batch_size);
+                destroy_node(head);
+                if (i < from_spare) {
+                    push_spare(head);  // Запас возвращается в запас
+                } else if (!in_batch) {
+                    node_traits::deallocate(allocator_, head, 1);
+                }
+                head = next;
+            }
+            for (size_t i = 0; i < batch_size; ++i) {
+                node_traits::deallocate(allocator_, batch + i, 1);
+            }
+            throw;
+        }
+
+        // Присоединяем цепочку к списку
+        if (head) {
+            if (!head_) {
+                head_ = head;
+            } else {
+                tail_->next = head;
+            }
+            tail_ = tail;
+        }
+        size_ += added;
+        // Одна точка на всю вставку: узел - последний, size - после вставки
+        if (added) {
+            ALLOCATOR_PROBE3(push_back, this, tail_, size_);
+        }
+    }
+
+    // Запас узлов: указатель на следующий хранится в начале сырой памяти
+    // узла, как в списке свободных слотов my_allocator
+    void push_spare(Node* node) noexcept {
+        std::memcpy(static_cast<void*>(node), &spare_, sizeof(Node*));
+        spare_ = node;
+        ++spare_count_;
+    }
+
+    Node* pop_spare() noexcept {
+        Node* node = spare_;
+        std::memcpy(&spare_, static_cast<void*>(node), sizeof(Node*));
+        --spare_count_;
+        return node;
+    }
+
+    // Быстрая очистка вместе с запасом: узлы не обходятся, аллокатор
+    // освобождает свою память разом. false - не поддерживается или у
+    // аллокатора есть другие копии; тогда ничего не меняется
+    bool release_all() noexcept {
+        if constexpr (bulk_clear) {
+            if (!allocator_.release()) return false;
+            head_ = tail_ = spare_ = nullptr;
+            size_ = spare_count_ = 0;
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    void release_spare() noexcept {
+        while (spare_) node_traits::deallocate(allocator_, pop_spare(), 1);
+    }
+
+    // Разрушение элементов узла и самого узла без освобождения памяти
+    void destroy_node(Node* node) noexcept {
+        if constexpr (unrolled) {
+            // Элементы узла разрушаются до самого узла
+            for (std::size_t i = 0; i < node->count; ++i) {
+                node_traits::destroy(allocator_, node->items + i);
+            }
+        }
+        node_traits::destroy(allocator_, node);  // Вызываем деструктор узла
+    }
+
+    // Конструирует элемент в конце и возвращает узел, в который он попал.
+    // При исключении контейнер не меняется
+    template <typename... Args>
+    Node* append_element(Args&&... args) {
+        if constexpr (unrolled) {
+            if (tail_ && tail_->count < NodeCapacity) {
+                // Свободное место в хвостовом узле: без обращения к аллокатору
+                node_traits::construct(allocator_, tail_->items + tail_->count, std::forward<Args>(args)...);
+                ++tail_->count;
+                ++size_;
+                return tail_;
+            }
+        }
+
+        // Узел из запаса или новый
+        bool cached = spare_ != nullptr;
+        Node* new_node = cached ? pop_spare() : node_traits::allocate(allocator_, 1);
+        try {
+            // Конструируем узел в выделенной памяти
+            if constexpr (unrolled) {
+                node_traits::construct(allocator_, new_node);
+                try {
+                    node_traits::construct(allocator_, new_node->items, std::forward<Args>(args)...);
+                } catch (...) {
+                    node_traits::destroy(allocator_, new_node);
+                    throw;
+                }
+                new_node->count = 1;
+            } else {
+                node_traits::construct(allocator_, new_node, std::forward<Args>(args)...);
+            }
+        } catch (...) {
+            // В случае исключения при конструировании освобождаем память
+            if (cached) {
+                push_spare(new_node);
+            } else {
+                node_traits::deallocate(allocator_, new_node, 1);
+            }
+            throw;  // Пробрасываем исключение дальше
+        }
+        
+        // Добавляем узел в список
+        if (!head_) {
+            // Если список пуст - новый узел становится и головой и хвостом
+            head_ = tail_ = new_node;
+        } else {
+            // Иначе добавляем в конец
+            tail_->next = new_node;
+            tail_ = new_node;
+        }
+        ++size_;  // Увеличиваем счетчик элементов
+        return new_node;
+    }
 };
 
 #endif
\ No newline at end of file
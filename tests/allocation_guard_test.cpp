@@ -0,0 +1,126 @@
+// Тесты allocation_guard на my_container с my_allocator: сколько вызовов
+// аллокатора и operator new делают вставки после reserve, повторное
+// заполнение, копирование и быстрое освобождение.
+// Собирается с MY_ALLOCATOR_GUARD и подсчетом глобального operator new
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "allocation_guard.h"
+#include "my_allocator.h"
+#include "my_container.h"
+#include "test_support.h"
+
+ALLOCATION_GUARD_DEFINE_GLOBAL_NEW()
+
+namespace {
+
+using alloc_type = my_allocator<int, 64>;
+
+template <typename Container>
+void fill(Container& c, int n) {
+    for (int i = 0; i < n; ++i) c.push_back(i);
+}
+
+// Трасса и профили по указателям (сборки без bulk_release) сами
+// пользуются operator new; там проверяются только вызовы аллокатора
+constexpr bool trackers_use_new = !alloc_type::bulk_release;
+
+// Ни одного вызова аллокатора и, где это возможно, operator new
+allocation_budget nothing() {
+    if (!trackers_use_new) return allocation_budget::none();
+    allocation_budget budget;
+    budget.allocator_calls = 0;
+    return budget;
+}
+
+// Сама охрана: считает вызовы аллокатора и operator new в своем потоке
+// и записывает нарушение бюджета в итог (сообщение в stderr ожидаемо)
+void test_guard_counts() {
+    allocation_guard::reset_summary();
+    {
+        my_container<int, alloc_type> c;
+        allocation_budget budget;
+        budget.allocator_calls = 10;
+        allocation_guard guard("counts", budget);
+        fill(c, 10);
+        CHECK(guard.usage().allocator_calls == 10);
+        CHECK(guard.within_budget());
+        fill(c, 1);
+        CHECK(!guard.within_budget());
+    }
+    {
+        allocation_guard guard("new");
+        std::vector<int> v(16);
+        CHECK(guard.usage().new_calls == 1);
+        CHECK(guard.usage().new_bytes == 16 * sizeof(int));
+        CHECK(guard.usage().allocator_calls == 0);
+    }
+    auto summary = allocation_guard::summary();
+    CHECK(summary["counts"].entries == 1 && summary["counts"].violations == 1);
+    CHECK(summary["new"].entries == 1 && summary["new"].violations == 0);
+}
+
+// После reserve(n) вставки до n не обращаются ни к аллокатору, ни к new
+template <std::size_t K>
+void test_push_back_after_reserve() {
+    my_container<int, alloc_type, K> c;
+    c.reserve(100);
+    allocation_guard guard("push_back after reserve", nothing());
+    fill(c, 100);
+    c.append(c.capacity() - c.size(), 7);
+    CHECK(guard.within_budget());
+}
+
+// Повторное заполнение после clear(true) без аллокаций
+template <std::size_t K>
+void test_refill_after_clear() {
+    my_container<int, alloc_type, K> c;
+    fill(c, 100);
+    allocation_guard guard("refill after clear(true)", nothing());
+    for (int round = 0; round < 3; ++round) {
+        c.clear(true);
+        fill(c, 100);
+    }
+    CHECK(guard.within_budget());
+}
+
+// Копия выделяет все узлы одним вызовом аллокатора
+template <std::size_t K>
+void test_copy_is_one_call() {
+    my_container<int, alloc_type, K> c;
+    fill(c, 100);
+    allocation_guard guard("copy");
+    my_container<int, alloc_type, K> copy(c);
+    CHECK(guard.usage().allocator_calls == 1);
+    CHECK(copy.size() == 100);
+}
+
+// Деструктор через release ничего не выделяет: ни аллокатором, ни new
+template <std::size_t K>
+void test_release_all_destructor() {
+    auto c = std::make_unique<my_container<int, alloc_type, K>>();
+    fill(*c, 1000);
+    c->reserve(1500);
+    allocation_guard guard("release_all destructor", nothing());
+    c.reset();
+    CHECK(guard.within_budget());
+}
+
+template <std::size_t K>
+void run_guard_tests() {
+    test_push_back_after_reserve<K>();
+    test_refill_after_clear<K>();
+    test_copy_is_one_call<K>();
+    test_release_all_destructor<K>();
+}
+
+} // namespace
+
+int main() {
+    static_assert(MY_ALLOCATOR_GUARD, "тест требует счетчиков allocation_guard");
+    test_guard_counts();
+    run_guard_tests<1>();
+    run_guard_tests<3>();
+    run_guard_tests<unrolled_capacity<int>>();
+    return test_support::result("allocation_guard_test");
+}
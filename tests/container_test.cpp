@@ -0,0 +1,695 @@
+// Тесты my_container: обычный и развернутый список, их итераторы,
+// копирование и перемещение, вставка диапазонов, запас узлов,
+// очистка и быстрое освобождение. Каждый тест прогоняется на
+// std::allocator, my_allocator и отказывающем аллокаторе, в режиме
+// списка и развернутого списка
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "my_allocator.h"
+#include "my_container.h"
+#include "test_support.h"
+
+namespace {
+
+// Элемент с подсчетом живых экземпляров; конструктор из int и
+// копирование бросают, когда обнуляется обратный отсчет throw_after
+struct tracked {
+    static inline int live = 0;
+    static inline int throw_after = -1;  // -1 - не бросать
+
+    std::string value;
+
+    static void tick() {
+        if (throw_after > 0 && --throw_after == 0) throw std::runtime_error("tracked");
+    }
+
+    tracked(int v) : value(std::to_string(v) + "-payload-longer-than-sso") {
+        tick();
+        ++live;
+    }
+    tracked(const tracked& other) : value(other.value) {
+        tick();
+        ++live;
+    }
+    ~tracked() { --live; }
+
+    tracked& operator=(const tracked&) = default;
+
+    bool operator==(int v) const { return value == std::to_string(v) + "-payload-longer-than-sso"; }
+};
+
+// Бросать после n-го конструирования (n >= 1); 0 - не бросать
+struct throw_guard {
+    explicit throw_guard(int n) { tracked::throw_after = n > 0 ? n : -1; }
+    ~throw_guard() { tracked::throw_after = -1; }
+};
+
+// Аллокатор поверх std::allocator: считает невозвращенные блоки и
+// бросает bad_alloc на fail_after-м по счету allocate
+struct failing_state {
+    static inline int outstanding = 0;
+    static inline int fail_after = -1;  // -1 - не бросать
+};
+
+template <typename T>
+struct failing_allocator {
+    using value_type = T;
+
+    failing_allocator() noexcept = default;
+    template <typename U>
+    failing_allocator(const failing_allocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        if (failing_state::fail_after > 0 && --failing_state::fail_after == 0) throw std::bad_alloc();
+        ++failing_state::outstanding;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        --failing_state::outstanding;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const failing_allocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const failing_allocator<U>&) const noexcept { return false; }
+};
+
+struct allocation_failure_guard {
+    explicit allocation_failure_guard(int n) { failing_state::fail_after = n > 0 ? n : -1; }
+    ~allocation_failure_guard() { failing_state::fail_after = -1; }
+};
+
+// Элементы контейнера - ровно 0, 1, ..., n - 1
+template <typename Container>
+bool holds_sequence(const Container& c, int n) {
+    if (c.size() != static_cast<std::size_t>(n)) return false;
+    int expected = 0;
+    for (const auto& item : c) {
+        if (!(item == expected)) return false;
+        ++expected;
+    }
+    return expected == n;
+}
+
+template <typename Container>
+void fill(Container& c, int from, int to) {
+    for (int i = from; i < to; ++i) c.emplace_back(i);
+}
+
+// Обход: все элементы по порядку, в том числе неполный хвостовой узел
+template <typename Container>
+void test_iteration() {
+    for (int n : {0, 1, 2, 7, 12, 13, 100}) {
+        Container c;
+        fill(c, 0, n);
+        CHECK(holds_sequence(c, n));
+        CHECK((c.begin() == c.end()) == (n == 0));
+
+        // Постфиксный инкремент и const_iterator из iterator
+        int count = 0;
+        for (typename Container::const_iterator it = c.begin(); it != c.cend(); it++) ++count;
+        CHECK(count == n);
+        CHECK(std::distance(c.cbegin(), c.cend()) == n);
+
+        // Изменение через iterator видно при обходе
+        for (auto& item : c) item.value += "!";
+        for (const auto& item : c) CHECK(item.value.back() == '!');
+    }
+    CHECK(tracked::live == 0);
+}
+
+// Число узлов: неполным бывает только хвостовой
+template <typename Container>
+void test_memory_usage() {
+    constexpr std::size_t k = Container::node_capacity;
+    Container c;
+    fill(c, 0, 25);
+    auto usage = c.memory_usage();
+    CHECK(usage.elements == 25);
+    CHECK(usage.elements_per_node == k);
+    CHECK(usage.nodes == (25 + k - 1) / k);
+    CHECK(usage.node_bytes == usage.nodes * usage.node_size);
+    CHECK(usage.payload_bytes == 25 * sizeof(tracked));
+}
+
+template <typename Container>
+void test_copy_and_move() {
+    {
+        Container a;
+        fill(a, 0, 30);
+        Container b(a);
+        CHECK(holds_sequence(a, 30));
+        CHECK(holds_sequence(b, 30));
+
+        // Копия независима: дозапись в нее не меняет оригинал
+        fill(b, 30, 40);
+        CHECK(holds_sequence(a, 30));
+        CHECK(holds_sequence(b, 40));
+
+        Container c(std::move(b));
+        CHECK(b.empty() && b.begin() == b.end());
+        CHECK(holds_sequence(c, 40));
+
+        // Перемещенный контейнер пригоден к использованию
+        fill(b, 0, 5);
+        CHECK(holds_sequence(b, 5));
+
+        a = c;
+        CHECK(holds_sequence(a, 40));
+        a = std::move(b);
+        CHECK(holds_sequence(a, 5));
+        const Container& self = a;
+        a = self;
+        CHECK(holds_sequence(a, 5));
+    }
+    CHECK(tracked::live == 0);
+}
+
+// emplace_back с исключением элемента или аллокатора не меняет
+// контейнер, в том числе когда элемент строится в свободном месте
+// хвостового узла
+template <typename Container>
+void test_emplace_rollback() {
+    int outstanding = failing_state::outstanding;
+    {
+        Container c;
+        fill(c, 0, 5);
+        for (int attempt = 0; attempt < 3; ++attempt) {
+            throw_guard guard(1);
+            CHECK_THROWS(std::runtime_error, c.emplace_back(5));
+            CHECK(holds_sequence(c, 5));
+        }
+        fill(c, 5, 20);
+        CHECK(holds_sequence(c, 20));
+
+        // Отказ аллокатора (только у failing_allocator): элемент не
+        // строится, контейнер прежний
+        for (int attempt = 0; attempt < 3; ++attempt) {
+            std::size_t size = c.size();
+            allocation_failure_guard guard(1);
+            try {
+                for (int i = 0; i < 20; ++i) c.emplace_back(static_cast<int>(c.size()));
+            } catch (const std::bad_alloc&) {
+                CHECK(c.size() >= size);
+            }
+            CHECK(holds_sequence(c, static_cast<int>(c.size())));
+            CHECK(tracked::live == static_cast<int>(c.size()));
+        }
+    }
+    CHECK(tracked::live == 0);
+    CHECK(failing_state::outstanding == outstanding);
+}
+
+// Содержимое - последовательность values
+template <typename Container>
+bool holds(const Container& c, const std::vector<int>& values) {
+    if (c.size() != values.size()) return false;
+    auto it = values.begin();
+    for (const auto& item : c) {
+        if (!(item == *it++)) return false;
+    }
+    return true;
+}
+
+template <typename Container>
+void test_append_and_range_constructors() {
+    {
+        std::vector<int> values{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13};
+        Container from_range(values.begin(), values.end());
+        CHECK(holds_sequence(from_range, 14));
+
+        Container from_list{0, 1, 2, 3};
+        CHECK(holds_sequence(from_list, 4));
+
+        Container filled(std::size_t(5), tracked(7));
+        CHECK(filled.size() == 5);
+        for (const auto& item : filled) CHECK(item == 7);
+
+        // Однопроходный диапазон
+        std::istringstream in("0 1 2 3 4 5 6 7 8 9");
+        Container from_stream{std::istream_iterator<int>(in), std::istream_iterator<int>()};
+        CHECK(holds_sequence(from_stream, 10));
+
+        // Дозапись в неполный хвостовой узел и дальше
+        Container c;
+        fill(c, 0, 4);
+        c.append(values.begin() + 4, values.end());
+        CHECK(holds_sequence(c, 14));
+        c.append(values.begin(), values.begin());
+        c.append(0, tracked(1));
+        CHECK(holds_sequence(c, 14));
+        c.append(3, tracked(14));
+        CHECK(c.size() == 17);
+    }
+    CHECK(tracked::live == 0);
+}
+
+// Диапазон из самого контейнера: добавляются только прежние элементы
+template <typename Container>
+void test_self_append() {
+    for (int n : {0, 1, 2, 5, 12, 13, 30}) {
+        Container c;
+        fill(c, 0, n);
+        c.append(c.begin(), c.end());
+        std::vector<int> expected;
+        for (int round = 0; round < 2; ++round) {
+            for (int i = 0; i < n; ++i) expected.push_back(i);
+        }
+        CHECK(holds(c, expected));
+
+        // Поддиапазон, заканчивающийся в хвостовом узле
+        if (n > 2) {
+            auto from = c.begin();
+            std::advance(from, 2 * n - 2);
+            c.append(from, c.end());
+            expected.push_back(n - 2);
+            expected.push_back(n - 1);
+            CHECK(holds(c, expected));
+        }
+
+        // Значение - элемент самого контейнера
+        if (n > 0) {
+            c.append(3, *c.begin());
+            for (int i = 0; i < 3; ++i) expected.push_back(0);
+            CHECK(holds(c, expected));
+        }
+    }
+    CHECK(tracked::live == 0);
+}
+
+// Строгая гарантия: исключение на любом элементе или любой аллокации
+// не меняет контейнер и не оставляет ни элементов, ни памяти
+template <typename Container>
+void test_append_rollback() {
+    std::vector<int> values;
+    for (int i = 5; i < 40; ++i) values.push_back(i);
+    int outstanding = failing_state::outstanding;
+    {
+        Container c;
+        fill(c, 0, 5);
+        const int live = tracked::live;
+        for (int failure = 1; failure <= 40; ++failure) {
+            throw_guard guard(failure);
+            try {
+                c.append(values.begin(), values.end());
+                break;
+            } catch (const std::runtime_error&) {
+                CHECK(holds_sequence(c, 5));
+                CHECK(tracked::live == live);
+            }
+        }
+        CHECK(holds_sequence(c, 40));
+
+        for (int failure = 1; failure <= 40; ++failure) {
+            allocation_failure_guard guard(failure);
+            try {
+                Container copy(c);
+                CHECK(holds_sequence(copy, 40));
+                break;
+            } catch (const std::bad_alloc&) {
+                CHECK(tracked::live == 40);
+            }
+        }
+
+        // Копирование с исключением в середине не оставляет узлов
+        for (int failure = 1; failure <= 40; ++failure) {
+            throw_guard guard(failure);
+            try {
+                Container copy(c);
+                break;
+            } catch (const std::runtime_error&) {
+                CHECK(tracked::live == 40);
+            }
+        }
+
+        // Присваивание с исключением не меняет приемник
+        Container target;
+        fill(target, 0, 3);
+        {
+            throw_guard guard(10);
+            CHECK_THROWS(std::runtime_error, target = c);
+        }
+        CHECK(holds_sequence(target, 3));
+    }
+    CHECK(tracked::live == 0);
+    CHECK(failing_state::outstanding == outstanding);
+}
+
+// reserve: емкость и запас узлов, заполнение запаса по порядку
+template <typename Container>
+void test_reserve() {
+    constexpr std::size_t k = Container::node_capacity;
+    {
+        Container c;
+        CHECK(c.capacity() == 0);
+        c.reserve(0);
+        CHECK(c.capacity() == 0 && c.memory_usage().spare_nodes == 0);
+
+        c.reserve(25);
+        CHECK(c.empty());
+        CHECK(c.capacity() >= 25 && c.capacity() < 25 + k);
+        CHECK(c.memory_usage().spare_nodes == (25 + k - 1) / k);
+
+        // Меньший запрос ничего не меняет
+        std::size_t capacity = c.capacity();
+        c.reserve(10);
+        CHECK(c.capacity() == capacity);
+
+        fill(c, 0, 25);
+        CHECK(holds_sequence(c, 25));
+        CHECK(c.capacity() == capacity);
+        CHECK(c.memory_usage().spare_nodes == 0);
+
+        // reserve на непустом контейнере считает от size()
+        c.reserve(40);
+        CHECK(c.capacity() >= 40);
+        fill(c, 25, 40);
+        CHECK(holds_sequence(c, 40));
+        c.append(std::size_t(5), tracked(1));
+        CHECK(c.size() == 45);
+    }
+    CHECK(tracked::live == 0);
+}
+
+// Копирующее присваивание при равных аллокаторах сохраняет запас
+// reserve(): узлы копии выделяются до замены, запас переходит целиком
+template <typename Container>
+void test_copy_assign_keeps_reserve() {
+    constexpr std::size_t k = Container::node_capacity;
+    {
+        Container source;
+        fill(source, 0, 10);
+        Container target;
+        target.reserve(40);
+
+        target = source;
+        CHECK(holds_sequence(target, 10));
+        CHECK(holds_sequence(source, 10));
+        CHECK(target.memory_usage().spare_nodes == (40 + k - 1) / k);
+        CHECK(target.capacity() >= 50);
+    }
+    CHECK(tracked::live == 0);
+}
+
+// После reserve(n) заполнение до n не обращается к аллокатору;
+// исключение в reserve и в дозаписи не меняет запас
+template <typename Container>
+void test_reserve_without_allocations() {
+    int outstanding = failing_state::outstanding;
+    {
+        Container c;
+        fill(c, 0, 3);
+        c.reserve(30);
+        std::size_t capacity = c.capacity();
+        {
+            allocation_failure_guard guard(1);  // Любой allocate бросит
+            fill(c, 3, 30);
+            CHECK(holds_sequence(c, 30));
+            CHECK_THROWS(std::bad_alloc, fill(c, 30, static_cast<int>(capacity) + 1));
+        }
+        CHECK(c.capacity() == capacity);
+        CHECK(holds_sequence(c, static_cast<int>(capacity)));
+
+        // Отказ на любом узле reserve не меняет ни емкости, ни памяти
+        int before = failing_state::outstanding;
+        for (int failure = 1; failure <= 3; ++failure) {
+            allocation_failure_guard guard(failure);
+            CHECK_THROWS(std::bad_alloc, c.reserve(capacity + 60));
+            CHECK(c.capacity() == capacity);
+            CHECK(failing_state::outstanding == before);
+        }
+    }
+    {
+        // Дозапись с исключением возвращает взятые узлы в запас
+        Container c;
+        fill(c, 0, 5);
+        c.reserve(20);
+        std::size_t capacity = c.capacity();
+        std::size_t spare = c.memory_usage().spare_nodes;
+        std::vector<int> values;
+        for (int i = 5; i < 40; ++i) values.push_back(i);
+        for (int failure : {1, 10, 20, 35}) {
+            throw_guard guard(failure);
+            CHECK_THROWS(std::runtime_error, c.append(values.begin(), values.end()));
+            CHECK(holds_sequence(c, 5));
+            CHECK(c.capacity() == capacity);
+            CHECK(c.memory_usage().spare_nodes == spare);
+        }
+    }
+    CHECK(tracked::live == 0);
+    CHECK(failing_state::outstanding == outstanding);
+}
+
+// clear(true) оставляет узлы в запасе, shrink_to_fit их возвращает,
+// clear() освобождает узлы элементов, но не запас
+template <typename Container>
+void test_clear_and_shrink() {
+    constexpr std::size_t k = Container::node_capacity;
+    {
+        Container c;
+        fill(c, 0, 25);
+        std::size_t nodes = c.memory_usage().nodes;
+        c.clear(true);
+        CHECK(c.empty() && c.begin() == c.end());
+        CHECK(tracked::live == 0);
+        CHECK(c.memory_usage().spare_nodes == nodes);
+        CHECK(c.capacity() == nodes * k);
+
+        // Повторное заполнение и повторная очистка
+        for (int round = 0; round < 3; ++round) {
+            fill(c, 0, 25);
+            CHECK(holds_sequence(c, 25));
+            CHECK(c.memory_usage().spare_nodes == 0);
+            c.clear(true);
+            CHECK(c.memory_usage().spare_nodes == nodes);
+        }
+
+        // Пустой контейнер: clear(true) запас не меняет
+        c.clear(true);
+        CHECK(c.memory_usage().spare_nodes == nodes);
+
+        c.shrink_to_fit();
+        CHECK(c.capacity() == 0 && c.memory_usage().spare_nodes == 0);
+        c.shrink_to_fit();
+        fill(c, 0, 7);
+        CHECK(holds_sequence(c, 7));
+
+        // clear() без аргумента сохраняет запас из reserve
+        c.reserve(30);
+        std::size_t spare = c.memory_usage().spare_nodes;
+        c.clear();
+        CHECK(c.empty() && c.memory_usage().spare_nodes == spare);
+        fill(c, 0, 3);
+        CHECK(holds_sequence(c, 3));
+    }
+    CHECK(tracked::live == 0);
+}
+
+// Заполнение после clear(true) не обращается к аллокатору, а
+// shrink_to_fit возвращает ему всю память запаса
+template <typename Container>
+void test_refill_without_allocations() {
+    int outstanding = failing_state::outstanding;
+    {
+        Container c;
+        fill(c, 0, 30);
+        int with_nodes = failing_state::outstanding;
+        {
+            allocation_failure_guard guard(1);  // Любой allocate бросит
+            for (int round = 0; round < 3; ++round) {
+                c.clear(true);
+                fill(c, 0, 30);
+                CHECK(holds_sequence(c, 30));
+            }
+        }
+        c.clear(true);
+        CHECK(failing_state::outstanding == with_nodes);
+        c.shrink_to_fit();
+        CHECK(failing_state::outstanding == outstanding);
+    }
+    CHECK(tracked::live == 0);
+    CHECK(failing_state::outstanding == outstanding);
+}
+
+// Быстрая очистка через my_allocator::release (тривиальные элементы,
+// единственная копия аллокатора) и обход узлов, если есть другие копии
+// или запас. Быстрая очистка - одно освобождение на все узлы
+template <std::size_t K>
+void test_release_all() {
+    using alloc_type = my_allocator<int, 64>;
+    using container = my_container<int, alloc_type, K>;
+#if MY_ALLOCATOR_STATS
+    constexpr std::size_t nodes = (200 + K - 1) / K;
+    constexpr std::size_t fast_deallocations = alloc_type::bulk_release ? 1 : nodes;
+    auto deallocations_since = [](const global_allocator_stats& before) {
+        return allocator_global_stats().deallocate_calls - before.deallocate_calls;
+    };
+    global_allocator_stats before = allocator_global_stats();
+#endif
+
+    // Деструктор: единственная копия - release, чанки возвращаются
+    {
+        container c;
+        fill(c, 0, 200);
+        CHECK(holds_sequence(c, 200));
+    }
+#if MY_ALLOCATOR_STATS
+    CHECK(deallocations_since(before) == fast_deallocations);
+    CHECK(allocator_global_stats().live_bytes() == before.live_bytes());
+    CHECK(allocator_global_stats().reserved_bytes() == before.reserved_bytes());
+    before = allocator_global_stats();
+#endif
+
+    // Другая копия аллокатора: обход узлов, чанки остаются у копии
+    {
+        alloc_type alloc;
+        {
+            container c(alloc);
+            fill(c, 0, 200);
+        }
+#if MY_ALLOCATOR_STATS
+        CHECK(deallocations_since(before) == nodes);
+        CHECK(allocator_global_stats().live_bytes() == before.live_bytes());
+        CHECK(allocator_global_stats().reserved_bytes() > before.reserved_bytes());
+#endif
+    }
+#if MY_ALLOCATOR_STATS
+    CHECK(allocator_global_stats().reserved_bytes() == before.reserved_bytes());
+#endif
+
+    // clear(): после release контейнер снова заполняется
+    {
+        container c;
+        fill(c, 0, 200);
+#if MY_ALLOCATOR_STATS
+        before = allocator_global_stats();
+#endif
+        c.clear();
+        CHECK(c.empty() && c.begin() == c.end());
+#if MY_ALLOCATOR_STATS
+        CHECK(deallocations_since(before) == fast_deallocations);
+#endif
+        fill(c, 0, 50);
+        CHECK(holds_sequence(c, 50));
+
+        // С запасом узлов clear() обходит узлы и запас сохраняет
+        c.reserve(100);
+        std::size_t spare = c.memory_usage().spare_nodes;
+        c.clear();
+        CHECK(c.empty() && c.memory_usage().spare_nodes == spare);
+        fill(c, 0, 100);
+        CHECK(holds_sequence(c, 100));
+    }
+
+    // Перемещающее присваивание освобождает прежние узлы приемника
+    {
+#if MY_ALLOCATOR_STATS
+        before = allocator_global_stats();
+#endif
+        {
+            container a;
+            fill(a, 0, 200);
+            container b;
+            fill(b, 0, 10);
+            a = std::move(b);
+            CHECK(holds_sequence(a, 10));
+            CHECK(b.empty());
+            fill(b, 0, 5);
+            CHECK(holds_sequence(b, 5));
+        }
+#if MY_ALLOCATOR_STATS
+        CHECK(allocator_global_stats().live_bytes() == before.live_bytes());
+        CHECK(allocator_global_stats().reserved_bytes() == before.reserved_bytes());
+#endif
+    }
+}
+
+#if MY_ALLOCATOR_STATS
+// Узлы, выделенные пачкой и освобожденные поштучно, учитываются
+// по слотам: число выделений и освобождений сходится
+template <std::size_t K>
+void test_batch_accounting() {
+    using alloc_type = my_allocator<tracked, 4>;
+    global_allocator_stats before = allocator_global_stats();
+    {
+        alloc_type alloc;
+        alloc_type other(alloc);  // Вторая копия: узлы возвращаются поштучно
+        my_container<tracked, alloc_type, K> c(alloc);
+        c.reserve(20);
+        fill(c, 0, 40);
+        c.append(std::size_t(30), tracked(1));
+        CHECK(c.size() == 70);
+    }
+    global_allocator_stats after = allocator_global_stats();
+    CHECK(after.allocate_calls - before.allocate_calls == after.deallocate_calls - before.deallocate_calls);
+    CHECK(after.live_bytes() == before.live_bytes());
+    CHECK(tracked::live == 0);
+}
+#endif
+
+template <typename Container>
+void run_unrolled_tests() {
+    test_iteration<Container>();
+    test_memory_usage<Container>();
+    test_copy_and_move<Container>();
+    test_emplace_rollback<Container>();
+}
+
+template <typename Container>
+void run_append_tests() {
+    test_append_and_range_constructors<Container>();
+    test_self_append<Container>();
+    test_append_rollback<Container>();
+}
+
+template <typename Container>
+void run_container_tests() {
+    run_unrolled_tests<Container>();
+    run_append_tests<Container>();
+    test_reserve<Container>();
+    test_clear_and_shrink<Container>();
+}
+
+template <typename Alloc>
+void run_all() {
+    run_container_tests<my_container<tracked, Alloc>>();
+    run_container_tests<my_container<tracked, Alloc, 3>>();
+    run_container_tests<my_container<tracked, Alloc, unrolled_capacity<tracked, 2>>>();
+    if constexpr (std::allocator_traits<Alloc>::is_always_equal::value) {
+        test_copy_assign_keeps_reserve<my_container<tracked, Alloc>>();
+        test_copy_assign_keeps_reserve<my_container<tracked, Alloc, 3>>();
+    }
+}
+
+} // namespace
+
+int main() {
+    static_assert(unrolled_capacity<int> == 12, "узел int занимает одну строку кэша");
+    static_assert(unrolled_capacity<char[100]> == 1, "крупный элемент - один на узел");
+
+    run_all<std::allocator<tracked>>();
+    run_all<my_allocator<tracked, 4>>();
+    run_all<failing_allocator<tracked>>();
+    test_reserve_without_allocations<my_container<tracked, failing_allocator<tracked>>>();
+    test_reserve_without_allocations<my_container<tracked, failing_allocator<tracked>, 3>>();
+    test_reserve_without_allocations<my_container<tracked, failing_allocator<tracked>, unrolled_capacity<tracked, 2>>>();
+    test_refill_without_allocations<my_container<tracked, failing_allocator<tracked>>>();
+    test_refill_without_allocations<my_container<tracked, failing_allocator<tracked>, 3>>();
+    test_refill_without_allocations<my_container<tracked, failing_allocator<tracked>, unrolled_capacity<tracked, 2>>>();
+    test_release_all<1>();
+    test_release_all<3>();
+    test_release_all<unrolled_capacity<int>>();
+#if MY_ALLOCATOR_STATS
+    test_batch_accounting<1>();
+    test_batch_accounting<3>();
+#endif
+    return test_support::result("container_test");
+}
@@ -0,0 +1,174 @@
+// Снимок кучи по SIGUSR2: файл allocator_lab.<pid>.1.heap во временном
+// каталоге, строки чанков с живыми слотами и картой занятости, таблица
+// фрагментации по размерам слотов.
+// Собирается с MY_ALLOCATOR_SNAPSHOT, только там, где есть сигналы
+#include <array>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "heap_snapshot.h"
+#include "my_allocator.h"
+#include "test_support.h"
+
+namespace {
+
+using slot8_alloc = my_allocator<std::uint64_t, 16>;
+using slot32_alloc = my_allocator<std::array<char, 32>, 8>;
+
+// Текст снимка, когда поток записи его закончил (последняя строка
+// таблицы фрагментации - с классом слотов 32); пустая строка по таймауту
+std::string wait_for_snapshot(const std::string& path) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (std::chrono::steady_clock::now() < deadline) {
+        std::ifstream in(path);
+        if (in) {
+            std::ostringstream text;
+            text << in.rdbuf();
+            std::string s = text.str();
+            std::size_t table = s.find("# fragmentation by slot size");
+            if (table != std::string::npos && s.find("\n        32 ", table) != std::string::npos &&
+                s.back() == '\n') {
+                return s;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return std::string();
+}
+
+std::vector<std::string> lines_starting_with(const std::string& text, const std::string& prefix) {
+    std::vector<std::string> found;
+    std::istringstream in(text);
+    for (std::string line; std::getline(in, line);) {
+        if (line.compare(0, prefix.size(), prefix) == 0) found.push_back(line);
+    }
+    return found;
+}
+
+struct chunk_line {
+    std::size_t slots = 0, used = 0, live = 0;
+    std::string occupancy;
+};
+
+bool parse_chunk(const std::string& line, chunk_line& out) {
+    void* address = nullptr;
+    if (std::sscanf(line.c_str(), "  chunk %p slots %zu used %zu live %zu [", &address,
+                    &out.slots, &out.used, &out.live) != 4) {
+        return false;
+    }
+    std::size_t open = line.find('['), close = line.rfind(']');
+    if (open == std::string::npos || close == std::string::npos || close < open) return false;
+    out.occupancy = line.substr(open + 1, close - open - 1);
+    return true;
+}
+
+struct class_row {
+    std::size_t slot = 0, arenas = 0, chunks = 0;
+    unsigned long long reserved = 0, live = 0, freed = 0, unused = 0;
+    double fragmentation = 0.0;
+};
+
+// Строка таблицы фрагментации для слота slot
+bool find_class(const std::string& text, std::size_t slot, class_row& out) {
+    std::istringstream in(text.substr(text.find("# fragmentation by slot size")));
+    for (std::string line; std::getline(in, line);) {
+        class_row row;
+        if (std::sscanf(line.c_str(), "%zu %zu %zu %llu %llu %llu %llu %lf%%", &row.slot, &row.arenas,
+                        &row.chunks, &row.reserved, &row.live, &row.freed, &row.unused, &row.fragmentation) == 8 &&
+            row.slot == slot) {
+            out = row;
+            return true;
+        }
+    }
+    return false;
+}
+
+void test_snapshot_on_signal() {
+    // Арена слотов по 8 байт: чанк на 16 слотов, занято 10, освобождены
+    // 0, 4 и 9; блок из 20 слотов - отдельный чанк, и после deallocate
+    // он остается живым
+    slot8_alloc small;
+    std::vector<std::uint64_t*> singles;
+    for (int i = 0; i < 10; ++i) singles.push_back(small.allocate(1));
+    std::uint64_t* block = small.allocate(20);
+    small.deallocate(singles[0], 1);
+    small.deallocate(singles[4], 1);
+    small.deallocate(singles[9], 1);
+    small.deallocate(block, 20);
+
+    // Арена слотов по 32 байта: один полный чанк
+    slot32_alloc wide;
+    for (int i = 0; i < 8; ++i) wide.allocate(1);
+
+    std::filesystem::path directory =
+        std::filesystem::temp_directory_path() / ("allocator_lab_snapshot_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(directory);
+    CHECK(heap_snapshot::install_signal_handler(directory.string().c_str()));
+    CHECK(std::raise(SIGUSR2) == 0);
+
+    std::string path = (directory / ("allocator_lab." + std::to_string(::getpid()) + ".1.heap")).string();
+    std::string text = wait_for_snapshot(path);
+    CHECK(!text.empty());
+    if (text.empty()) return;
+
+    auto arenas = lines_starting_with(text, "arena ");
+    std::size_t slot8_arenas = 0;
+    for (const std::string& line : arenas) {
+        if (line.find(" slot 8 chunks 2 reserved 288 live 216") != std::string::npos) ++slot8_arenas;
+    }
+    CHECK(slot8_arenas == 1);
+
+    auto chunks = lines_starting_with(text, "  chunk ");
+    CHECK(chunks.size() == 3);
+    if (chunks.size() == 3) {
+        chunk_line first, second, third;
+        CHECK(parse_chunk(chunks[0], first) && parse_chunk(chunks[1], second) && parse_chunk(chunks[2], third));
+        // Порядок арен в снимке не задан; чанки арены идут по порядку выделения
+        const chunk_line* partial = nullptr;
+        const chunk_line* pinned = nullptr;
+        const chunk_line* full = nullptr;
+        for (const chunk_line* c : {&first, &second, &third}) {
+            if (c->slots == 16) partial = c;
+            else if (c->slots == 20) pinned = c;
+            else if (c->slots == 8) full = c;
+        }
+        CHECK(partial && pinned && full);
+        if (partial && pinned && full) {
+            CHECK(partial->used == 10 && partial->live == 7);
+            CHECK(partial->occupancy == "_###_####_      ");
+            CHECK(pinned->used == 20 && pinned->live == 20);
+            CHECK(pinned->occupancy == std::string(20, '#'));
+            CHECK(full->used == 8 && full->live == 8);
+            CHECK(full->occupancy == "########");
+        }
+    }
+
+    class_row slot8, slot32;
+    CHECK(find_class(text, 8, slot8));
+    CHECK(slot8.arenas == 1 && slot8.chunks == 2);
+    CHECK(slot8.reserved == 288 && slot8.live == 216 && slot8.freed == 24 && slot8.unused == 48);
+    CHECK(slot8.fragmentation > 24.9 && slot8.fragmentation < 25.1);
+    CHECK(find_class(text, 32, slot32));
+    CHECK(slot32.arenas == 1 && slot32.chunks == 1);
+    CHECK(slot32.reserved == 256 && slot32.live == 256 && slot32.freed == 0 && slot32.unused == 0);
+    CHECK(slot32.fragmentation < 0.1);
+
+    std::filesystem::remove_all(directory);
+}
+
+} // namespace
+
+int main() {
+    static_assert(MY_ALLOCATOR_SNAPSHOT, "тест требует реестра арен");
+    test_snapshot_on_signal();
+    return test_support::result("heap_snapshot_test");
+}
@@ -0,0 +1,61 @@
+// Теги мест вызова в профиле времени жизни: контейнеры называются
+// строкой этого файла, где они созданы, а не строкой заголовка.
+// Собирается с MY_ALLOCATOR_LIFETIME (и, значит, MY_ALLOCATOR_TAGS)
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+#include "lifetime_profiler.h"
+#include "my_allocator.h"
+#include "my_container.h"
+#include "test_support.h"
+
+namespace {
+
+// Тег, созданный строкой line этого файла в функции main
+std::string site_name(unsigned line) {
+    return "lifetime_sites_test.cpp:" + std::to_string(line) + " main";
+}
+
+const lifetime_profiler::site_lifetime* find(const std::vector<lifetime_profiler::site_lifetime>& sites,
+                                             const std::string& name) {
+    for (const auto& site : sites) {
+        if (site.name == name) return &site;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+int main() {
+    static_assert(MY_ALLOCATOR_TAGS, "профиль времени жизни включает теги");
+    using alloc_type = my_allocator<int, 4>;
+    std::vector<int> values{0, 1, 2, 3, 4};
+
+    unsigned default_line = 0;
+    unsigned range_line = 0;
+    {
+        my_container<int, alloc_type> by_default; default_line = __LINE__;
+        for (int i = 0; i < 6; ++i) by_default.push_back(i);
+        my_container<int, alloc_type> by_range(values.begin(), values.end()); range_line = __LINE__;
+
+        // Контейнер STL - с явным тегом
+        using map_alloc = my_allocator<std::pair<const int, int>, 4>;
+        std::map<int, int, std::less<int>, map_alloc> map(map_alloc(allocation_tag::named("test map")));
+        for (int i = 0; i < 3; ++i) map[i] = i;
+    }
+
+    auto sites = lifetime_profiler::report();
+    const auto* by_default = find(sites, site_name(default_line));
+    const auto* by_range = find(sites, site_name(range_line));
+    const auto* map = find(sites, "test map");
+    CHECK(by_default && by_default->allocations == 6 && by_default->live == 0);
+    CHECK(by_range && by_range->allocations == 5 && by_range->live == 0);
+    CHECK(map && map->allocations == 3);
+
+    // Ни один тег не указывает в заголовки
+    for (const auto& site : sites) {
+        CHECK(site.name.find(".h:") == std::string::npos);
+    }
+    return test_support::result("lifetime_sites_test");
+}
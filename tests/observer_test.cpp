@@ -0,0 +1,155 @@
+// Тесты наблюдателей my_allocator: какие события приходят, с какими
+// байтами и числом чанков, и что обработчик может выделять память
+// через ту же арену, не попадая под ее блокировку.
+// Собирается с MY_ALLOCATOR_OBSERVER
+#include <cstddef>
+#include <new>
+#include <vector>
+#include "allocator_observer.h"
+#include "my_allocator.h"
+#include "test_support.h"
+
+namespace {
+
+// Запоминает события по видам
+struct recorder : allocator_observer {
+    std::vector<allocator_event> acquired, released, slow, oom, trimmed;
+
+    void on_chunk_acquire(const allocator_event& e) override { acquired.push_back(e); }
+    void on_chunk_release(const allocator_event& e) override { released.push_back(e); }
+    void on_slow_path(const allocator_event& e) override { slow.push_back(e); }
+    void on_oom(const allocator_event& e) override { oom.push_back(e); }
+    void on_trim(const allocator_event& e) override { trimmed.push_back(e); }
+};
+
+// Наблюдатель на время теста
+struct scoped_observer {
+    allocator_observer* observer;
+    explicit scoped_observer(allocator_observer* o) : observer(o) { allocator_observers::add(o); }
+    ~scoped_observer() { allocator_observers::remove(observer); }
+};
+
+// Источник чанков, который отказывает после limit выделений
+struct failing_chunk_source {
+    static inline int limit = 0;
+
+    static void* allocate(std::size_t bytes, std::size_t alignment) {
+        if (limit-- <= 0) throw std::bad_alloc();
+        return heap_chunk_source::allocate(bytes, alignment);
+    }
+    static void release(void* p, std::size_t bytes, std::size_t alignment) noexcept {
+        heap_chunk_source::release(p, bytes, alignment);
+    }
+};
+
+struct failing_policy : default_allocator_policy {
+    using chunk_source = failing_chunk_source;
+};
+
+// Копии аллокатора с настоящим мьютексом арены
+struct locked_policy : default_allocator_policy {
+    using threading = mutex_threaded;
+};
+
+// Новый чанк: slow_path с байтами запроса, затем acquire с байтами
+// чанка; освобождение - release по чанку с убывающим счетчиком
+void test_chunk_events() {
+    recorder events;
+    scoped_observer scope(&events);
+    const void* first = nullptr;
+    const void* second = nullptr;
+    {
+        my_allocator<int, 16> alloc;
+        int* a = alloc.allocate(10);
+        first = a;
+        CHECK(events.slow.size() == 1 && events.slow[0].bytes == 10 * sizeof(int) && events.slow[0].chunks == 0);
+        CHECK(events.acquired.size() == 1 && events.acquired[0].address == a &&
+              events.acquired[0].bytes == 16 * sizeof(int) && events.acquired[0].chunks == 1 &&
+              events.acquired[0].slot_size == sizeof(int));
+
+        // Место в чанке есть: событий нет
+        alloc.allocate(6);
+        CHECK(events.slow.size() == 1 && events.acquired.size() == 1);
+
+        // Запрос больше чанка получает чанк ровно под себя
+        int* b = alloc.allocate(40);
+        second = b;
+        CHECK(events.slow.size() == 2 && events.slow[1].bytes == 40 * sizeof(int) && events.slow[1].chunks == 1);
+        CHECK(events.acquired.size() == 2 && events.acquired[1].address == b &&
+              events.acquired[1].bytes == 40 * sizeof(int) && events.acquired[1].chunks == 2);
+        CHECK(events.released.empty() && events.oom.empty());
+    }
+    CHECK(events.released.size() == 2);
+    if (events.released.size() == 2) {
+        CHECK(events.released[0].address == first && events.released[0].bytes == 16 * sizeof(int) &&
+              events.released[0].chunks == 1);
+        CHECK(events.released[1].address == second && events.released[1].bytes == 40 * sizeof(int) &&
+              events.released[1].chunks == 0);
+    }
+}
+
+// release() единственной копии: on_trim со всеми байтами чанков
+void test_trim_event() {
+    using alloc_type = my_allocator<int, 16>;
+    if constexpr (!alloc_type::bulk_release) return;
+    recorder events;
+    scoped_observer scope(&events);
+    alloc_type alloc;
+    alloc.allocate(10);
+    alloc.allocate(20);
+    alloc.release();
+    CHECK(events.trimmed.size() == 1);
+    CHECK(!events.trimmed.empty() && events.trimmed[0].bytes == (16 + 20) * sizeof(int) &&
+          events.trimmed[0].chunks == 0);
+    CHECK(events.released.size() == 2);
+}
+
+// Отказ источника чанков: slow_path, on_oom с байтами чанка, bad_alloc
+void test_oom_event() {
+    recorder events;
+    scoped_observer scope(&events);
+    failing_chunk_source::limit = 1;
+    my_allocator<int, 16, failing_policy> alloc;
+    alloc.allocate(16);
+    CHECK_THROWS(std::bad_alloc, alloc.allocate(1));
+    CHECK(events.slow.size() == 2 && events.acquired.size() == 1);
+    CHECK(events.oom.size() == 1 && events.oom[0].bytes == 16 * sizeof(int) && events.oom[0].chunks == 1);
+}
+
+// Обработчик выделяет память через ту же арену: блокировка арены к
+// этому моменту снята, вложенные события не доставляются
+struct reentrant : allocator_observer {
+    my_allocator<int, 16, locked_policy> alloc;
+    std::vector<int*> taken;
+    int acquired = 0;
+
+    void on_slow_path(const allocator_event&) override { taken.push_back(alloc.allocate(1)); }
+    void on_chunk_acquire(const allocator_event&) override {
+        ++acquired;
+        taken.push_back(alloc.allocate(32));  // Свой новый чанк - без события
+    }
+};
+
+void test_reentrant_allocation() {
+    reentrant handler;
+    scoped_observer scope(&handler);
+    my_allocator<int, 16, locked_policy> copy(handler.alloc);
+    int* p = copy.allocate(16);
+    CHECK(handler.acquired == 1);
+    CHECK(handler.taken.size() == 2);
+    for (int* q : handler.taken) CHECK(q && q != p);
+    *p = 1;
+    for (int* q : handler.taken) *q = 2;
+    CHECK(*p == 1);
+}
+
+} // namespace
+
+int main() {
+    static_assert(MY_ALLOCATOR_OBSERVER, "тест требует наблюдателей");
+    test_chunk_events();
+    test_trim_event();
+    test_oom_event();
+    test_reentrant_allocation();
+    return test_support::result("observer_test");
+}
@@ -0,0 +1,110 @@
+// Политики my_allocator: minimal_allocator_policy не заходит ни в
+// счетчики статистики, ни в замер латентности, ни во временную шкалу,
+// ни в очередь наблюдателей, ни в allocation_guard, даже когда все это
+// собрано в программу. Поток, работающий только с таким аллокатором,
+// не заводит своих блоков счетчиков.
+// Собирается с MY_ALLOCATOR_LATENCY, MY_ALLOCATOR_GUARD,
+// MY_ALLOCATOR_OBSERVER, MY_ALLOCATOR_TIMELINE и MY_ALLOCATOR_SNAPSHOT
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include "allocation_guard.h"
+#include "my_allocator.h"
+#include "test_support.h"
+
+static_assert(!minimal_allocator_policy::statistics, "минимальная политика без статистики");
+static_assert(!minimal_allocator_policy::tracing, "минимальная политика без средств наблюдения");
+
+namespace {
+
+using minimal_alloc = my_allocator<std::size_t, 64, minimal_allocator_policy>;
+using default_alloc = my_allocator<std::size_t, 64>;
+
+// Чанки, список свободных слотов, пачки и release - все пути аллокатора.
+// Замеры самого my_container (push_back, clear) от политики аллокатора
+// не зависят, поэтому здесь только вызовы аллокатора
+template <typename Alloc>
+void churn() {
+    Alloc alloc;
+    std::vector<std::size_t*> slots;
+    for (int i = 0; i < 200; ++i) slots.push_back(alloc.allocate(1));
+    for (std::size_t* p : slots) alloc.deallocate(p, 1);
+    for (int i = 0; i < 100; ++i) slots[i] = alloc.allocate(1);
+    std::size_t* block = alloc.allocate(300);
+    alloc.deallocate(block, 300);
+    std::size_t* batch = alloc.allocate_batch(50);
+    for (std::size_t i = 0; i < 50; ++i) alloc.deallocate(batch + i, 1);
+    if constexpr (Alloc::bulk_release) alloc.release();
+}
+
+// Отметки потока: завел ли он блоки счетчиков статистики, латентности
+// и временной шкалы, заходил ли в очередь событий наблюдателей
+struct touched {
+    bool stats = false;
+    bool latency = false;
+    bool timeline = false;
+    bool observers = false;
+};
+
+template <typename Alloc>
+touched churn_in_fresh_thread() {
+    touched result;
+    std::thread worker([&] {
+        churn<Alloc>();
+#if MY_ALLOCATOR_STATS
+        result.stats = allocator_stats_detail::tls_counters != nullptr;
+#endif
+        result.latency = latency::detail::tls_histograms != nullptr;
+        result.timeline = timeline_trace::detail::tls_buffer != nullptr;
+        result.observers = allocator_observers::detail::deferred_used;
+    });
+    worker.join();
+    return result;
+}
+
+void test_minimal_touches_nothing() {
+    // С наблюдателем события медленного пути доходят до очереди
+    allocator_observer observer;
+    allocator_observers::add(&observer);
+
+    touched minimal = churn_in_fresh_thread<minimal_alloc>();
+    CHECK(!minimal.stats);
+    CHECK(!minimal.latency);
+    CHECK(!minimal.timeline);
+    CHECK(!minimal.observers);
+
+    // Проверка сама по себе различает: политика по умолчанию заходит туда
+    touched full = churn_in_fresh_thread<default_alloc>();
+    CHECK(full.stats == static_cast<bool>(MY_ALLOCATOR_STATS));
+    CHECK(full.latency);
+    CHECK(full.timeline);
+    CHECK(full.observers);
+
+    allocator_observers::remove(&observer);
+}
+
+void test_minimal_not_counted() {
+#if MY_ALLOCATOR_STATS
+    auto before = allocator_global_stats();
+    churn<minimal_alloc>();
+    auto after = allocator_global_stats();
+    CHECK(after.allocate_calls == before.allocate_calls);
+    CHECK(after.chunks_acquired == before.chunks_acquired);
+#endif
+    allocation_budget budget;
+    budget.allocator_calls = 0;
+    allocation_guard guard("minimal policy", budget);
+    churn<minimal_alloc>();
+    CHECK(guard.usage().allocator_calls == 0);
+}
+
+} // namespace
+
+int main() {
+    static_assert(MY_ALLOCATOR_LATENCY && MY_ALLOCATOR_GUARD, "тест требует замера латентности и allocation_guard");
+    static_assert(MY_ALLOCATOR_OBSERVER && MY_ALLOCATOR_TIMELINE && MY_ALLOCATOR_SNAPSHOT,
+                  "тест требует наблюдателей, временной шкалы и снимков кучи");
+    test_minimal_touches_nothing();
+    test_minimal_not_counted();
+    return test_support::result("policy_test");
+}
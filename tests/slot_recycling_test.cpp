@@ -0,0 +1,98 @@
+// Повторное использование слотов my_allocator: одиночный слот после
+// deallocate возвращается следующим allocate(1), слоты типов меньше
+// указателя и блоки из нескольких элементов не переиспользуются,
+// а разрушение аллокатора не вызывает деструкторов элементов
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include "my_allocator.h"
+#include "test_support.h"
+
+namespace {
+
+// Элемент, который считает вызовы своего деструктора
+struct counted {
+    static inline int destroyed = 0;
+    std::uint64_t payload[2] = {};
+    ~counted() { ++destroyed; }
+};
+
+void test_single_slot_reused() {
+    my_allocator<std::uint64_t, 8> alloc;
+    std::uint64_t* first = alloc.allocate(1);
+    std::uint64_t* second = alloc.allocate(1);
+    alloc.deallocate(first, 1);
+    CHECK(alloc.allocate(1) == first);
+
+    // Список освобожденных - стек: последним освобожден - первым выдан
+    std::uint64_t* third = alloc.allocate(1);
+    alloc.deallocate(second, 1);
+    alloc.deallocate(third, 1);
+    CHECK(alloc.allocate(1) == third);
+    CHECK(alloc.allocate(1) == second);
+
+    // Слот, освобожденный через копию, достается исходному аллокатору
+    my_allocator<std::uint64_t, 8> copy(alloc);
+    std::uint64_t* shared = alloc.allocate(1);
+    copy.deallocate(shared, 1);
+    CHECK(alloc.allocate(1) == shared);
+}
+
+// В слот меньше указателя ссылка списка не помещается
+void test_small_type_not_recycled() {
+    my_allocator<std::uint16_t, 8> alloc;
+    static_assert(sizeof(std::uint16_t) < sizeof(void*), "тип должен быть меньше указателя");
+    std::uint16_t* first = alloc.allocate(1);
+    alloc.deallocate(first, 1);
+    std::uint16_t* next = alloc.allocate(1);
+    CHECK(next != first);
+    CHECK(next == first + 1);
+#if MY_ALLOCATOR_STATS
+    CHECK(alloc.stats().free_bytes == 0);
+#endif
+}
+
+// p внутри [first, first + n); std::less, потому что чанки разные
+template <typename T>
+bool inside(const T* p, const T* first, std::size_t n) {
+    std::less<const T*> before;
+    return !before(p, first) && before(p, first + n);
+}
+
+// Блок из нескольких элементов остается в чанке
+void test_block_not_recycled() {
+    my_allocator<std::uint64_t, 16> alloc;
+    std::uint64_t* block = alloc.allocate(4);
+    alloc.deallocate(block, 4);
+#if MY_ALLOCATOR_STATS
+    CHECK(alloc.stats().free_bytes == 0);
+#endif
+    std::uint64_t* single = alloc.allocate(1);
+    CHECK(!inside(single, block, 4));
+    std::uint64_t* again = alloc.allocate(4);
+    for (std::size_t i = 0; i < 4; ++i) CHECK(!inside(again + i, block, 4));
+}
+
+// Объекты разрушает владелец; аллокатор при разрушении их не трогает
+void test_destructor_does_not_destroy_elements() {
+    counted::destroyed = 0;
+    {
+        my_allocator<counted, 4> alloc;
+        counted* live = alloc.allocate(1);
+        ::new (static_cast<void*>(live)) counted();
+        counted* freed = alloc.allocate(1);
+        alloc.deallocate(freed, 1);
+    }
+    CHECK(counted::destroyed == 0);
+}
+
+} // namespace
+
+int main() {
+    test_single_slot_reused();
+    test_small_type_not_recycled();
+    test_block_not_recycled();
+    test_destructor_does_not_destroy_elements();
+    return test_support::result("slot_recycling_test");
+}
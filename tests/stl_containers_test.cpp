@@ -0,0 +1,140 @@
+// my_allocator под std::deque и unordered-контейнерами. Они выделяют
+// карту deque и массив корзин через временную rebind-копию аллокатора;
+// пока копии владели отдельными аренами, эта память освобождалась вместе
+// с временной копией, и контейнер работал с освобожденной памятью.
+// Где компилятор умеет, тест собирается с AddressSanitizer: ошибка
+// проявляется как heap-use-after-free, а не как неверная сумма
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include "my_allocator.h"
+#include "test_support.h"
+
+namespace {
+
+template <typename T>
+using alloc = my_allocator<T, 64>;
+
+using map_type = std::unordered_map<int, std::uint64_t, std::hash<int>, std::equal_to<int>,
+                                    alloc<std::pair<const int, std::uint64_t>>>;
+using set_type = std::unordered_set<int, std::hash<int>, std::equal_to<int>, alloc<int>>;
+using deque_type = std::deque<std::uint64_t, alloc<std::uint64_t>>;
+
+// Вставка с рехешированием, поиск, удаление половины и повторная вставка
+void test_unordered_map() {
+    map_type map;
+    for (int i = 0; i < 20000; ++i) map.emplace(i, static_cast<std::uint64_t>(i) * 3);
+    CHECK(map.size() == 20000);
+    std::uint64_t sum = 0;
+    for (int i = 0; i < 20000; ++i) {
+        auto it = map.find(i);
+        if (it != map.end()) sum += it->second;
+    }
+    CHECK(sum == 3ull * 19999 * 20000 / 2);
+
+    for (int i = 0; i < 20000; i += 2) map.erase(i);
+    map.rehash(64);
+    for (int i = 0; i < 20000; i += 2) map[i] = 1;
+    sum = 0;
+    for (const auto& entry : map) sum += entry.second;
+    CHECK(sum == 3ull * (10000ull * 10000) + 10000);
+
+    // Копия и перемещение контейнера уносят аллокатор вместе с памятью
+    map_type copy(map);
+    map_type moved(std::move(map));
+    map = copy;
+    CHECK(copy.size() == 20000 && moved.size() == 20000 && map.size() == 20000);
+    map.clear();
+    copy.swap(moved);
+    CHECK(copy.count(19999) == 1 && moved.count(1) == 1);
+}
+
+void test_unordered_set() {
+    set_type set;
+    for (int i = 0; i < 5000; ++i) set.insert(i * 7);
+    for (int i = 0; i < 5000; i += 3) set.erase(i * 7);
+    std::size_t found = 0;
+    for (int i = 0; i < 5000; ++i) found += set.count(i * 7);
+    CHECK(found == set.size());
+    set_type other;
+    other = set;
+    set.clear();
+    CHECK(other.size() == found);
+}
+
+// Рост карты deque с обоих концов и ее перестройка при снятии элементов
+void test_deque() {
+    deque_type deque;
+    for (std::uint64_t i = 0; i < 30000; ++i) {
+        if (i % 2) deque.push_back(i);
+        else deque.push_front(i);
+    }
+    for (int i = 0; i < 10000; ++i) {
+        deque.pop_front();
+        deque.pop_back();
+    }
+    deque.shrink_to_fit();
+    std::uint64_t sum = 0;
+    for (std::uint64_t v : deque) sum += v;
+    CHECK(deque.size() == 10000);
+
+    deque_type copy(deque);
+    std::uint64_t copy_sum = 0;
+    for (std::uint64_t v : copy) copy_sum += v;
+    CHECK(copy_sum == sum);
+    deque = deque_type();
+    CHECK(deque.empty());
+}
+
+// То же, что делают контейнеры, напрямую: память временной rebind-копии
+// переживает копию и освобождается через любую равную
+void test_rebound_copy_outlives_temporary() {
+    alloc<int> original;
+    std::uint64_t* block = nullptr;
+    {
+        alloc<std::uint64_t> temporary(original);
+        CHECK(temporary == original);
+        block = temporary.allocate(8);
+        for (int i = 0; i < 8; ++i) block[i] = static_cast<std::uint64_t>(i);
+    }
+    alloc<std::uint64_t> later(original);
+    std::uint64_t sum = 0;
+    for (int i = 0; i < 8; ++i) sum += block[i];
+    CHECK(sum == 28);
+    later.deallocate(block, 8);
+
+    // Перемещенный аллокатор остается рабочим и равным
+    alloc<int> moved(std::move(original));
+    CHECK(moved == original);
+    original.deallocate(moved.allocate(1), 1);
+}
+
+// Узловой контейнер, пережив аллокатор, из которого он скопирован
+void test_container_outlives_source_allocator() {
+    std::list<int, alloc<int>>* list = nullptr;
+    {
+        alloc<int> source;
+        list = new std::list<int, alloc<int>>(source);
+        for (int i = 0; i < 1000; ++i) list->push_back(i);
+    }
+    long sum = 0;
+    for (int v : *list) sum += v;
+    CHECK(sum == 999L * 1000 / 2);
+    delete list;
+}
+
+} // namespace
+
+int main() {
+    test_unordered_map();
+    test_unordered_set();
+    test_deque();
+    test_rebound_copy_outlives_temporary();
+    test_container_outlives_source_allocator();
+    return test_support::result("stl_containers_test");
+}
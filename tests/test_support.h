@@ -0,0 +1,44 @@
+#ifndef TEST_SUPPORT_H
+#define TEST_SUPPORT_H
+
+#include <cstddef>
+#include <cstdio>
+#include <new>
+
+// Проверки для тестов: в отличие от assert работают и в Release.
+// Провал печатается и не прерывает тест; итог - код возврата result()
+namespace test_support {
+
+inline int failures = 0;
+
+inline void fail(const char* expr, const char* file, int line) {
+    std::fprintf(stderr, "%s:%d: проверка не прошла: %s\n", file, line, expr);
+    ++failures;
+}
+
+inline int result(const char* name) {
+    if (failures) {
+        std::fprintf(stderr, "%s: провалов %d\n", name, failures);
+        return 1;
+    }
+    std::printf("%s: ok\n", name);
+    return 0;
+}
+
+} // namespace test_support
+
+#define CHECK(expr) ((expr) ? (void)0 : test_support::fail(#expr, __FILE__, __LINE__))
+
+// Выражение должно бросить исключение типа E
+#define CHECK_THROWS(E, expr)                        \
+    do {                                             \
+        bool thrown_ = false;                        \
+        try {                                        \
+            expr;                                    \
+        } catch (const E&) {                         \
+            thrown_ = true;                          \
+        }                                            \
+        if (!thrown_) test_support::fail("бросает " #E ": " #expr, __FILE__, __LINE__); \
+    } while (0)
+
+#endif
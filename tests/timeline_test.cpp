@@ -0,0 +1,73 @@
+// Тесты счетчиков timeline_trace: отсчет от начала программы, а не от
+// start(), и сумма вкладов потоков, когда блок освобождает другой поток.
+// Собирается с MY_ALLOCATOR_TIMELINE
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "my_allocator.h"
+#include "test_support.h"
+
+namespace {
+
+using alloc_type = my_allocator<int, 1024>;
+
+// Значения счетчика name в JSON по порядку
+std::vector<long long> counter_values(const char* name) {
+    std::ostringstream out;
+    timeline_trace::write(out);
+    std::istringstream in(out.str());
+    std::string pattern = std::string("\"ph\": \"C\", \"cat\": \"allocator\", \"name\": \"") + name + "\"";
+    std::vector<long long> values;
+    for (std::string line; std::getline(in, line);) {
+        if (line.find(pattern) == std::string::npos) continue;
+        std::size_t at = line.find("\"value\": ");
+        long long value = 0;
+        if (at != std::string::npos && std::sscanf(line.c_str() + at, "\"value\": %lld", &value) == 1) {
+            values.push_back(value);
+        }
+    }
+    return values;
+}
+
+// Достаточно операций после паузы, чтобы поток записал отсчет
+void force_sample(alloc_type& alloc) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2 * timeline_trace::counter_interval_ns / 1000000));
+    for (int i = 0; i < 1024; ++i) alloc.deallocate(alloc.allocate(1), 1);
+}
+
+} // namespace
+
+int main() {
+    alloc_type alloc;
+    int* before_start = alloc.allocate(100);
+
+    timeline_trace::start();
+    {
+        // Первый отсчет - уже живые байты, а не ноль
+        auto live = counter_values("live_bytes");
+        CHECK(!live.empty() && live.front() == 100 * static_cast<long long>(sizeof(int)));
+        auto chunks = counter_values("chunks");
+        CHECK(!chunks.empty() && chunks.front() == 1);
+    }
+
+    // Освобождение блока, выделенного до start(), в другом потоке
+    int* in_thread = alloc.allocate(50);
+    std::thread worker([&] {
+        alloc.deallocate(before_start, 100);
+        alloc.deallocate(in_thread, 50);
+        force_sample(alloc);
+    });
+    worker.join();
+    force_sample(alloc);
+
+    auto live = counter_values("live_bytes");
+    CHECK(!live.empty());
+    for (long long value : live) CHECK(value >= 0);
+    // Последний отсчет - между allocate и deallocate одной пары или после нее
+    CHECK(!live.empty() && live.back() <= static_cast<long long>(sizeof(int)));
+    timeline_trace::stop();
+    return test_support::result("timeline_test");
+}
@@ -0,0 +1,159 @@
+// Тесты allocation_trace: запись из нескольких потоков с выгрузкой
+// переполненных буферов, flush посреди записи, повторный start и
+// чтение файлов версии 1.
+// Собирается с MY_ALLOCATOR_TRACE
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#include "allocation_trace.h"
+#include "my_allocator.h"
+#include "test_support.h"
+
+namespace {
+
+using alloc_type = my_allocator<std::uint64_t, 16>;
+using allocation_trace::op;
+using allocation_trace::record;
+
+// Файл во временном каталоге; метка времени разводит параллельные запуски
+std::string temp_path(const char* name) {
+    auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+    return (std::filesystem::temp_directory_path() /
+            ("allocator_lab_" + std::to_string(stamp) + "_" + name)).string();
+}
+
+bool is_sorted_by_time(const std::vector<record>& records) {
+    for (std::size_t i = 1; i < records.size(); ++i) {
+        if (records[i - 1].timestamp_ns > records[i].timestamp_ns) return false;
+    }
+    return true;
+}
+
+// Запись с адресом p и видом kind; nullptr - такой нет
+const record* find(const std::vector<record>& records, const void* p, op kind) {
+    for (const record& rec : records) {
+        if (rec.address == reinterpret_cast<std::uintptr_t>(p) && rec.kind == static_cast<std::uint8_t>(kind)) {
+            return &rec;
+        }
+    }
+    return nullptr;
+}
+
+// Два потока, буфер на 4 записи: часть записей уходит в файл при
+// переполнении, часть - через flush и stop
+void test_round_trip() {
+    std::string path = temp_path("trace_round_trip.altr");
+    CHECK(allocation_trace::start(path.c_str(), 4));
+    CHECK(!allocation_trace::start(path.c_str(), 4));  // Запись уже идет
+
+    alloc_type alloc;
+    std::uint64_t* single = alloc.allocate(1);
+    std::uint64_t* block = alloc.allocate(3);
+    alloc.deallocate(single, 1);
+
+    std::uint64_t* other = nullptr;
+    std::thread worker([&] {
+        alloc_type local;
+        other = local.allocate(2);
+        local.deallocate(other, 2);
+        for (int i = 0; i < 10; ++i) local.deallocate(local.allocate(1), 1);
+    });
+    worker.join();
+    allocation_trace::flush();
+
+    alloc.deallocate(block, 3);
+    allocation_trace::stop();
+    CHECK(!allocation_trace::enabled());
+
+    std::vector<record> records;
+    CHECK(allocation_trace::load(path.c_str(), records));
+    CHECK(records.size() == 4 + 2 + 20);
+    CHECK(is_sorted_by_time(records));
+
+    const record* a1 = find(records, single, op::allocate);
+    const record* d1 = find(records, single, op::deallocate);
+    const record* a3 = find(records, block, op::allocate);
+    const record* d3 = find(records, block, op::deallocate);
+    const record* a2 = find(records, other, op::allocate);
+    CHECK(a1 && d1 && a3 && d3 && a2);
+    if (a1 && d1 && a3 && d3 && a2) {
+        CHECK(a1->size == sizeof(std::uint64_t) && d1->size == sizeof(std::uint64_t));
+        CHECK(a3->size == 3 * sizeof(std::uint64_t) && d3->size == 3 * sizeof(std::uint64_t));
+        CHECK(a2->size == 2 * sizeof(std::uint64_t));
+        // Номера потоков - по порядку первой записи
+        CHECK(a1->thread == 0 && d3->thread == 0);
+        CHECK(a2->thread == 1);
+        CHECK(a1->timestamp_ns <= d1->timestamp_ns && a3->timestamp_ns <= d3->timestamp_ns);
+    }
+    std::size_t worker_records = 0;
+    for (const record& rec : records) worker_records += rec.thread == 1;
+    CHECK(worker_records == 22);
+
+    // Новая сессия: буфер потока от прошлой заменяется, в файле только новые записи
+    CHECK(allocation_trace::start(path.c_str(), 4));
+    std::uint64_t* again = alloc.allocate(1);
+    alloc.deallocate(again, 1);
+    allocation_trace::stop();
+    records.clear();
+    CHECK(allocation_trace::load(path.c_str(), records));
+    CHECK(records.size() == 2);
+    if (records.size() == 2) {
+        CHECK(records[0].kind == static_cast<std::uint8_t>(op::allocate));
+        CHECK(records[1].kind == static_cast<std::uint8_t>(op::deallocate));
+        CHECK(records[0].thread == 0);
+    }
+    std::remove(path.c_str());
+}
+
+// Файл версии 1 (32-битный размер) записан вручную вне порядка времени
+void test_load_version_1() {
+    std::string path = temp_path("trace_v1.altr");
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    CHECK(file != nullptr);
+    if (!file) return;
+    allocation_trace::file_header header;
+    std::memcpy(header.magic, allocation_trace::file_magic, sizeof(header.magic));
+    header.version = 1;
+    header.record_size = sizeof(allocation_trace::record_v1);
+    std::fwrite(&header, sizeof(header), 1, file);
+    const allocation_trace::record_v1 old[] = {
+        {300, 0x1000, 48, 1, static_cast<std::uint8_t>(op::deallocate), 0},
+        {100, 0x1000, 48, 1, static_cast<std::uint8_t>(op::allocate), 0},
+        {200, 0x2000, 4000000000u, 0, static_cast<std::uint8_t>(op::allocate), 0},
+    };
+    std::fwrite(old, sizeof(old[0]), 3, file);
+    std::fclose(file);
+
+    std::vector<record> records;
+    CHECK(allocation_trace::load(path.c_str(), records));
+    CHECK(records.size() == 3);
+    if (records.size() == 3) {
+        CHECK(records[0].timestamp_ns == 100 && records[1].timestamp_ns == 200 && records[2].timestamp_ns == 300);
+        CHECK(records[0].kind == static_cast<std::uint8_t>(op::allocate) && records[0].size == 48);
+        CHECK(records[1].address == 0x2000 && records[1].size == 4000000000u && records[1].thread == 0);
+        CHECK(records[2].kind == static_cast<std::uint8_t>(op::deallocate) && records[2].thread == 1);
+    }
+
+    // Размер записи, не совпадающий с версией, отвергается
+    file = std::fopen(path.c_str(), "wb");
+    header.record_size = sizeof(record);
+    std::fwrite(&header, sizeof(header), 1, file);
+    std::fclose(file);
+    records.clear();
+    CHECK(!allocation_trace::load(path.c_str(), records));
+    std::remove(path.c_str());
+}
+
+} // namespace
+
+int main() {
+    static_assert(MY_ALLOCATOR_TRACE, "тест требует записи трассы");
+    test_round_trip();
+    test_load_version_1();
+    return test_support::result("trace_test");
+}
@@ -0,0 +1,179 @@
+// Тесты генератора синтетических потоков (bench/workload_generator.h):
+// воспроизводимость по seed, парность allocate/deallocate, порядок
+// освобождения lifo/fifo, число живых блоков около LIVE и отказ на
+// неверных описаниях
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "test_support.h"
+#include "workload_generator.h"
+
+namespace {
+
+using workload::event;
+
+workload::config make_config(const std::string& spec) {
+    workload::config cfg;
+    std::string error;
+    bool ok = cfg.parse(spec, error);
+    CHECK(ok);
+    if (!ok) std::fprintf(stderr, "%s: %s\n", spec.c_str(), error.c_str());
+    return cfg;
+}
+
+std::vector<event> collect(const workload::config& cfg) {
+    std::vector<event> events;
+    workload::generator gen(cfg);
+    for (event e; gen.next(e);) events.push_back(e);
+    return events;
+}
+
+bool same(const std::vector<event>& a, const std::vector<event>& b) {
+    if (a.size() != b.size()) return false;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (a[i].op != b[i].op || a[i].id != b[i].id || a[i].size != b[i].size || a[i].thread != b[i].thread) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const char* const lifetimes[] = {"exp:100", "bimodal:10:1000:0.1", "lifo:200", "fifo:200"};
+
+void test_replayable_by_seed() {
+    for (const char* life : lifetimes) {
+        std::string spec = std::string("size=zipf:16:4096:1.1,life=") + life + ",threads=4:random,ops=5000";
+        auto first = collect(make_config(spec + ",seed=42"));
+        auto again = collect(make_config(spec + ",seed=42"));
+        auto other = collect(make_config(spec + ",seed=43"));
+        CHECK(!first.empty());
+        CHECK(same(first, again));
+        CHECK(!same(first, other));
+    }
+}
+
+// Каждый блок выделяется и освобождается ровно по разу, освобождение
+// после выделения и с тем же размером и потоком
+void test_every_allocation_freed_once() {
+    for (const char* life : lifetimes) {
+        std::string spec = std::string("size=uniform:1:512,life=") + life + ",threads=3:burst:7,ops=3000,seed=5";
+        std::map<std::uint64_t, event> live;
+        std::set<std::uint64_t> freed;
+        std::size_t allocations = 0;
+        bool paired = true;
+        for (const event& e : collect(make_config(spec))) {
+            if (e.op == event::allocate) {
+                ++allocations;
+                paired &= e.size >= 1 && e.size <= 512 && e.thread < 3;
+                paired &= live.emplace(e.id, e).second && !freed.count(e.id);
+            } else {
+                auto it = live.find(e.id);
+                paired &= it != live.end();
+                if (it == live.end()) continue;
+                paired &= it->second.size == e.size && it->second.thread == e.thread;
+                live.erase(it);
+                freed.insert(e.id);
+            }
+        }
+        CHECK(paired);
+        CHECK(allocations == 3000);
+        CHECK(live.empty());
+        CHECK(freed.size() == 3000);
+    }
+}
+
+// lifo освобождает самый новый живой блок, fifo - самый старый
+void test_lifo_fifo_order() {
+    for (const char* life : {"lifo:50", "fifo:50"}) {
+        bool lifo = std::string(life) == "lifo:50";
+        std::set<std::uint64_t> live;  // id растут в порядке выделения
+        bool ordered = true;
+        std::size_t frees = 0;
+        for (const event& e : collect(make_config(std::string("size=fixed:32,life=") + life + ",ops=2000,seed=7"))) {
+            if (e.op == event::allocate) {
+                live.insert(e.id);
+                continue;
+            }
+            ordered &= !live.empty() && e.id == (lifo ? *live.rbegin() : *live.begin());
+            live.erase(e.id);
+            ++frees;
+        }
+        CHECK(ordered);
+        CHECK(frees == 2000);
+    }
+}
+
+// После разгона число живых блоков держится у LIVE и не превышает его
+void test_live_count_settles() {
+    for (const char* life : {"lifo:200", "fifo:200"}) {
+        std::size_t live = 0, allocations = 0, samples = 0, peak = 0;
+        double total = 0.0;
+        for (const event& e : collect(make_config(std::string("size=fixed:32,life=") + life + ",ops=20000,seed=11"))) {
+            if (e.op == event::deallocate) {
+                --live;
+                continue;
+            }
+            ++live;
+            if (++allocations > 5000 && allocations <= 20000) {
+                total += static_cast<double>(live);
+                ++samples;
+                if (live > peak) peak = live;
+            }
+        }
+        double mean = total / static_cast<double>(samples);
+        CHECK(peak <= 200);
+        CHECK(mean >= 180.0);
+    }
+}
+
+void test_malformed_specs() {
+    const char* const bad[] = {
+        "size",                       // Нет '='
+        "color=red",                  // Неизвестный ключ
+        "size=fixed:0",
+        "size=uniform:10:5",
+        "size=zipf:0:4096:1.1",
+        "size=emp:16x0",
+        "size=emp:16",
+        "size=gauss:10",
+        "life=exp:0",
+        "life=bimodal:10:100:1.5",
+        "life=lifo:0",
+        "life=fifo",
+        "threads=0",
+        "threads=70000",
+        "threads=4:burst",
+        "threads=4:burst:0",
+        "threads=4:zigzag",
+        "ops=0",
+    };
+    for (const char* spec : bad) {
+        workload::config cfg;
+        std::string error;
+        bool ok = cfg.parse(spec, error);
+        CHECK(!ok);
+        if (ok) std::fprintf(stderr, "принято: %s\n", spec);
+        CHECK(!error.empty());
+    }
+
+    // Граница 16-битного номера потока еще допустима
+    workload::config cfg;
+    std::string error;
+    CHECK(cfg.parse("threads=65535:rr", error));
+    CHECK(cfg.threads.threads == 65535);
+}
+
+} // namespace
+
+int main() {
+    test_replayable_by_seed();
+    test_every_allocation_freed_once();
+    test_lifo_fifo_order();
+    test_live_count_settles();
+    test_malformed_specs();
+    return test_support::result("workload_test");
+}
@@ -0,0 +1,291 @@
+#ifndef TIMELINE_TRACE_H
+#define TIMELINE_TRACE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+// Переключатель временной шкалы: -DMY_ALLOCATOR_TIMELINE=1 встраивает
+// события в my_allocator. Запись включается во время выполнения
+// через timeline_trace::start()
+#ifndef MY_ALLOCATOR_TIMELINE
+#define MY_ALLOCATOR_TIMELINE 0
+#endif
+
+// Временная шкала аллокатора в формате Chrome Trace Event (JSON), который
+// открывают chrome://tracing и ui.perfetto.dev. Медленный путь (новый чанк),
+// освобождение арены и trim - отрезки на дорожке потока; живые байты и
+// число чанков - дорожки счетчиков. Счетчики ведутся с начала программы,
+// а не с start(), поэтому освобождение блоков, выделенных до start(), не
+// уводит их в минус. Время - steady_clock в микросекундах,
+// на Linux это CLOCK_MONOTONIC, как у большинства трассировщиков приложений,
+// поэтому файл можно смотреть рядом с их отрезками
+namespace timeline_trace {
+
+// Счетчики пишутся не чаще раза в этот интервал на поток (кроме смены чанков)
+constexpr std::int64_t counter_interval_ns = 1000000;
+constexpr std::size_t max_events_per_thread = 1 << 20;
+
+namespace detail {
+
+struct event {
+    char phase;         // 'X' - отрезок, 'C' - счетчик
+    const char* name;
+    std::int64_t ts_ns;
+    std::int64_t dur_ns;
+    std::int64_t value;  // Аргумент отрезка или значение счетчика
+};
+
+// Буфер потока: пишет владелец, читает flush; оба под mutex буфера,
+// который владелец почти всегда берет без конкуренции
+struct buffer {
+    std::mutex mutex;
+    std::vector<event> events;
+    std::uint64_t dropped = 0;
+    std::uint32_t thread = 0;
+
+    // Вклад потока в счетчики: пишет только владелец. Освобождение чужого
+    // блока делает вклад отрицательным; сумму по потокам считает write()
+    std::atomic<std::int64_t> live_bytes{0};
+    std::atomic<std::int64_t> chunks{0};
+    std::uint32_t operations = 0;           // С последней проверки времени
+    std::int64_t last_counter_ns = 0;
+};
+
+struct state {
+    std::mutex mutex;               // Список буферов
+    std::vector<buffer*> buffers;   // Не освобождаются: события потока живут после его завершения
+
+    static state& instance() {
+        static state* s = new state();
+        return *s;
+    }
+};
+
+inline std::atomic<bool> enabled{false};
+inline thread_local buffer* tls_buffer = nullptr;
+
+inline std::int64_t now_ns() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline buffer* local() noexcept {
+    if (tls_buffer) return tls_buffer;
+    state& s = state::instance();
+    try {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto* b = new buffer();
+        b->thread = static_cast<std::uint32_t>(s.buffers.size()) + 1;
+        s.buffers.push_back(b);
+        tls_buffer = b;
+    } catch (...) {
+        return nullptr;
+    }
+    return tls_buffer;
+}
+
+inline void bump(std::atomic<std::int64_t>& counter, std::int64_t delta) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+inline void push(buffer* b, const event& e) noexcept {
+    std::lock_guard<std::mutex> lock(b->mutex);
+    if (b->events.size() >= max_events_per_thread) {
+        ++b->dropped;
+        return;
+    }
+    try {
+        b->events.push_back(e);
+    } catch (...) {
+        ++b->dropped;
+    }
+}
+
+inline constexpr const char live_bytes_name[] = "live_bytes";
+inline constexpr const char chunks_name[] = "chunks";
+
+// Отсчет счетчиков - вклад только потока b: на пути аллокации берется
+// лишь mutex своего буфера, сумма собирается в write()
+inline void push_counters(buffer* b, std::int64_t ts) noexcept {
+    push(b, {'C', live_bytes_name, ts, 0, b->live_bytes.load(std::memory_order_relaxed)});
+    push(b, {'C', chunks_name, ts, 0, b->chunks.load(std::memory_order_relaxed)});
+}
+
+inline void emit_counters(buffer* b, std::int64_t ts) noexcept {
+    b->last_counter_ns = ts;
+    push_counters(b, ts);
+}
+
+inline void count_operation(buffer* b) noexcept {
+    // Часы опрашиваются раз в 1024 операции
+    if (++b->operations < 1024) return;
+    b->operations = 0;
+    std::int64_t ts = now_ns();
+    if (ts - b->last_counter_ns >= counter_interval_ns) emit_counters(b, ts);
+}
+
+} // namespace detail
+
+inline bool enabled() noexcept {
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+// Начало записи; события предыдущего запуска сбрасываются. Счетчики
+// не обнуляются: первый отсчет каждого потока - его текущий вклад
+inline void start() {
+    detail::state& s = detail::state::instance();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    std::int64_t ts = detail::now_ns();
+    for (detail::buffer* b : s.buffers) {
+        {
+            std::lock_guard<std::mutex> buffer_lock(b->mutex);
+            b->events.clear();
+            b->dropped = 0;
+        }
+        detail::push_counters(b, ts);
+    }
+    detail::enabled.store(true, std::memory_order_relaxed);
+}
+
+inline void stop() noexcept {
+    detail::enabled.store(false, std::memory_order_relaxed);
+}
+
+// Отрезок на дорожке потока: от конструктора до деструктора
+class slice {
+public:
+    slice(const char* name, std::int64_t value) noexcept
+        : name_(name), value_(value), start_(enabled() ? detail::now_ns() : -1) {}
+
+    ~slice() {
+        if (start_ < 0) return;
+        if (detail::buffer* b = detail::local()) {
+            std::int64_t end = detail::now_ns();
+            detail::push(b, {'X', name_, start_, end - start_, value_});
+        }
+    }
+
+    slice(const slice&) = delete;
+    slice& operator=(const slice&) = delete;
+
+private:
+    const char* name_;
+    std::int64_t value_;
+    std::int64_t start_;  // -1 - запись выключена
+};
+
+// Учет операций аллокатора; счетчики ведутся и при выключенной записи
+inline void record_allocate(std::size_t bytes) noexcept {
+    if (detail::buffer* b = detail::local()) {
+        detail::bump(b->live_bytes, static_cast<std::int64_t>(bytes));
+        if (enabled()) detail::count_operation(b);
+    }
+}
+
+inline void record_deallocate(std::size_t bytes) noexcept {
+    if (detail::buffer* b = detail::local()) {
+        detail::bump(b->live_bytes, -static_cast<std::int64_t>(bytes));
+        if (enabled()) detail::count_operation(b);
+    }
+}
+
+// Смена числа чанков; отсчет пишется сразу
+inline void record_chunks(std::int64_t delta) noexcept {
+    if (detail::buffer* b = detail::local()) {
+        detail::bump(b->chunks, delta);
+        if (enabled()) detail::emit_counters(b, detail::now_ns());
+    }
+}
+
+// JSON со всеми событиями с момента start(). Отсчеты счетчиков потоков
+// сливаются по времени: значение - сумма последних вкладов всех потоков.
+// Вклад потока известен только на момент его отсчета, поэтому сумма
+// может ненадолго уйти ниже нуля; такие значения выводятся как 0
+inline void write(std::ostream& out) {
+    detail::state& s = detail::state::instance();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    struct counter_sample {
+        std::int64_t ts_ns;
+        std::size_t thread;  // Номер буфера
+        bool chunks;
+        std::int64_t value;
+    };
+    std::vector<counter_sample> samples;
+    out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+    bool first = true;
+    char line[256];
+    auto emit = [&](const char* text) {
+        out << (first ? "  " : ",\n  ") << text;
+        first = false;
+    };
+    for (std::size_t index = 0; index < s.buffers.size(); ++index) {
+        detail::buffer* b = s.buffers[index];
+        std::lock_guard<std::mutex> buffer_lock(b->mutex);
+        if (b->events.empty() && b->dropped == 0) continue;
+        std::snprintf(line, sizeof(line),
+                      "{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 1, \"tid\": %u, "
+                      "\"args\": {\"name\": \"allocator thread %u\"}}", b->thread, b->thread);
+        emit(line);
+        for (const detail::event& e : b->events) {
+            if (e.phase == 'C') {
+                samples.push_back({e.ts_ns, index, std::strcmp(e.name, detail::chunks_name) == 0, e.value});
+                continue;
+            }
+            std::snprintf(line, sizeof(line),
+                          "{\"ph\": \"X\", \"cat\": \"allocator\", \"name\": \"%s\", \"pid\": 1, \"tid\": %u, "
+                          "\"ts\": %.3f, \"dur\": %.3f, \"args\": {\"bytes\": %lld}}",
+                          e.name, b->thread, static_cast<double>(e.ts_ns) / 1000.0,
+                          static_cast<double>(e.dur_ns) / 1000.0, static_cast<long long>(e.value));
+            emit(line);
+        }
+        if (b->dropped) {
+            std::snprintf(line, sizeof(line),
+                          "{\"ph\": \"i\", \"s\": \"t\", \"name\": \"dropped %llu events\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f}",
+                          static_cast<unsigned long long>(b->dropped), b->thread,
+                          b->events.empty() ? 0.0 : static_cast<double>(b->events.back().ts_ns) / 1000.0);
+            emit(line);
+        }
+    }
+
+    // Счетчики - дорожки процесса: сумма последних вкладов потоков
+    std::stable_sort(samples.begin(), samples.end(), [](const counter_sample& a, const counter_sample& b) {
+        return a.ts_ns < b.ts_ns;
+    });
+    std::vector<std::int64_t> contribution(2 * s.buffers.size());
+    std::int64_t totals[2] = {0, 0};
+    for (const counter_sample& sample : samples) {
+        std::int64_t& last = contribution[2 * sample.thread + sample.chunks];
+        std::int64_t& total = totals[sample.chunks];
+        total += sample.value - last;
+        last = sample.value;
+        std::snprintf(line, sizeof(line),
+                      "{\"ph\": \"C\", \"cat\": \"allocator\", \"name\": \"%s\", \"pid\": 1, "
+                      "\"ts\": %.3f, \"args\": {\"value\": %lld}}",
+                      sample.chunks ? detail::chunks_name : detail::live_bytes_name,
+                      static_cast<double>(sample.ts_ns) / 1000.0,
+                      static_cast<long long>(total > 0 ? total : 0));
+        emit(line);
+    }
+    out << "\n]}\n";
+}
+
+// Запись буферов в файл; можно вызывать многократно во время работы
+inline bool flush(const char* path) {
+    std::ofstream out(path);
+    if (!out) return false;
+    write(out);
+    return static_cast<bool>(out);
+}
+
+} // namespace timeline_trace
+
+#endif